@@ -0,0 +1,230 @@
+// Benchmark suite for the load, search, sale and report paths.
+// Usage: bookstore_bench [sales-size ...]   (defaults: 1000 10000 100000)
+// Each size gets a fresh generated dataset in a temporary directory; books and
+// customers are capped by MAX_BOOKS / MAX_CUSTOMERS, as the loaders are.
+// Results are printed as one JSON object per line.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../src/sales/sales.h"
+#include "../src/sales/sales_stats.h"
+#include "../src/sales/sales_aggregate.h"
+#include "../src/book/book_index.h"
+#include "../src/book/book_fuzzy.h"
+#include "../tools/datagen/datagen.h"
+
+#define LOAD_ITERATIONS 20
+#define LOOKUP_ITERATIONS 20000
+#define AGGREGATE_ITERATIONS 20
+
+typedef struct {
+    double *samples; // Seconds per operation
+    long count;
+} Latencies;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const Latencies *latencies, double fraction) {
+    long index = (long)(fraction * (latencies->count - 1) + 0.5);
+    return latencies->samples[index];
+}
+
+static void report(const char *op, long size, Latencies *latencies) {
+    if (latencies->count == 0) {
+        return;
+    }
+    double total = 0.0;
+    for (long i = 0; i < latencies->count; i++) {
+        total += latencies->samples[i];
+    }
+    qsort(latencies->samples, latencies->count, sizeof(double), compareDoubles);
+    printf("{\"op\":\"%s\",\"size\":%ld,\"ops\":%ld,\"ops_per_sec\":%.1f,\"p50_us\":%.3f,\"p99_us\":%.3f}\n",
+           op, size, latencies->count, latencies->count / total,
+           percentile(latencies, 0.50) * 1e6, percentile(latencies, 0.99) * 1e6);
+    fflush(stdout);
+    latencies->count = 0;
+}
+
+static void record(Latencies *latencies, double start) {
+    latencies->samples[latencies->count++] = nowSeconds() - start;
+}
+
+static void benchSize(long size, Latencies *latencies) {
+    DatagenConfig config;
+    defaultDatagenConfig(&config);
+    // One below the caps: the loaders warn as soon as they reach them
+    config.numBooks = MAX_BOOKS - 1;
+    config.numCustomers = MAX_CUSTOMERS - 1;
+    config.numSales = size;
+    config.outDir = "data"; // Our own scratch directory, regenerated per run
+    config.overwrite = 1;
+    if (generateDataset(&config) != 0) {
+        return;
+    }
+
+    static Book books[MAX_BOOKS];
+    static Customer customers[MAX_CUSTOMERS];
+    int numBooks = 0, numCustomers = 0, numSales = 0;
+    Sale *sales = malloc((size_t)size * sizeof(Sale));
+    if (!sales) {
+        perror("Memory allocation failed");
+        return;
+    }
+
+    // Load paths
+    for (int i = 0; i < LOAD_ITERATIONS; i++) {
+        double start = nowSeconds();
+        loadBooks(books, &numBooks);
+        record(latencies, start);
+    }
+    report("load_books", size, latencies);
+    for (int i = 0; i < LOAD_ITERATIONS; i++) {
+        double start = nowSeconds();
+        loadCustomers(customers, &numCustomers);
+        record(latencies, start);
+    }
+    report("load_customers", size, latencies);
+    for (int i = 0; i < LOAD_ITERATIONS; i++) {
+        double start = nowSeconds();
+        loadSalesInto(sales, &numSales, (int)size);
+        record(latencies, start);
+    }
+    report("load_sales", size, latencies);
+
+    // Lookups (random keys drawn from the loaded data, fixed seed)
+    srand(7);
+    for (int i = 0; i < LOOKUP_ITERATIONS && numBooks > 0; i++) {
+        int ISBN = books[rand() % numBooks].ISBN;
+        double start = nowSeconds();
+        searchBookByISBN(books, numBooks, ISBN);
+        record(latencies, start);
+    }
+    report("search_isbn", size, latencies);
+    for (int i = 0; i < LOOKUP_ITERATIONS && numBooks > 0; i++) {
+        char query[16];
+        strncpy(query, books[rand() % numBooks].title, 4);
+        query[4] = '\0';
+        double start = nowSeconds();
+        Book *found = searchBookByTitle(books, numBooks, query);
+        record(latencies, start);
+        free(found);
+    }
+    report("search_title", size, latencies);
+    for (int i = 0; i < LOOKUP_ITERATIONS && numBooks > 0; i++) {
+        // An eight-character slice of a title with one character mistyped; picks
+        // books without rand() so the later cases see the same key sequence
+        char query[16];
+        TitleMatch matches[MAX_BOOKS];
+        strncpy(query, books[(i * 7919) % numBooks].title, 8);
+        query[8] = '\0';
+        query[strlen(query) / 2] = 'x';
+        double start = nowSeconds();
+        searchBooksByTitleFuzzy(books, numBooks, query, 2, 1, matches, MAX_BOOKS);
+        record(latencies, start);
+    }
+    report("search_title_fuzzy", size, latencies);
+    for (int i = 0; i < LOOKUP_ITERATIONS && numCustomers > 0; i++) {
+        int customerID = customers[rand() % numCustomers].customerID;
+        double start = nowSeconds();
+        searchCustomerByID(customers, numCustomers, customerID);
+        record(latencies, start);
+    }
+    report("customer_lookup", size, latencies);
+
+    // Report aggregation (the work behind displaySalesReport when totals are
+    // rebuilt), one worker against one per CPU on the same growable tables
+    SalesAggregate aggregate;
+    for (int i = 0; i < AGGREGATE_ITERATIONS; i++) {
+        double start = nowSeconds();
+        if (aggregateSalesParallel(sales, numSales, 1, &aggregate) == 0) {
+            freeSalesAggregate(&aggregate);
+        }
+        record(latencies, start);
+    }
+    report("report_aggregate_serial", size, latencies);
+    for (int i = 0; i < AGGREGATE_ITERATIONS; i++) {
+        double start = nowSeconds();
+        if (aggregateSalesParallel(sales, numSales, 0, &aggregate) == 0) {
+            freeSalesAggregate(&aggregate);
+        }
+        record(latencies, start);
+    }
+    report("report_aggregate_parallel", size, latencies);
+
+    // Checkout into an empty history, bounded by MAX_SALES
+    Sale *checkoutSales = malloc(MAX_SALES * sizeof(Sale));
+    int numCheckoutSales = 0;
+    for (int i = 0; i < numBooks; i++) {
+        books[i].quantity = MAX_SALES; // Never run out of stock mid-run
+    }
+    rebuildCatalogIndex(books, numBooks);
+    for (int i = 0; checkoutSales && i < MAX_SALES && numBooks > 0 && numCustomers > 0; i++) {
+        BasketItem item = {books[rand() % numBooks].ISBN, 1};
+        int customerID = customers[rand() % numCustomers].customerID;
+        double start = nowSeconds();
+        processBasket(books, numBooks, customers, numCustomers, checkoutSales, &numCheckoutSales, customerID, &item, 1);
+        record(latencies, start);
+    }
+    report("checkout", size, latencies);
+
+    free(checkoutSales);
+    free(sales);
+}
+
+static void removeDataset(void) {
+    const char *files[] = {"data/books.csv", "data/customers.csv", "data/sales.csv", "data/sales_stats.csv"};
+    for (int i = 0; i < (int)(sizeof(files) / sizeof(files[0])); i++) {
+        unlink(files[i]);
+    }
+    rmdir("data");
+}
+
+int main(int argc, char *argv[]) {
+    long defaultSizes[] = {1000, 10000, 100000};
+    int numSizes = argc > 1 ? argc - 1 : 3;
+
+    // The loaders use fixed relative paths, so run inside a scratch directory
+    char workDir[] = "/tmp/bookstore_bench.XXXXXX";
+    if (!mkdtemp(workDir) || chdir(workDir) != 0 || mkdir("data", 0755) != 0) {
+        perror("Error preparing benchmark directory");
+        return 1;
+    }
+
+    // Every benchmark records at most LOOKUP_ITERATIONS samples before reporting
+    Latencies latencies;
+    latencies.count = 0;
+    latencies.samples = malloc(LOOKUP_ITERATIONS * sizeof(double));
+    if (!latencies.samples) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+
+    for (int i = 0; i < numSizes; i++) {
+        long size = argc > 1 ? atol(argv[i + 1]) : defaultSizes[i];
+        if (size <= 0) {
+            fprintf(stderr, "Error: Sizes must be positive.\n");
+            continue;
+        }
+        benchSize(size, &latencies);
+    }
+
+    free(latencies.samples);
+    removeDataset();
+    if (chdir("/") == 0) {
+        rmdir(workDir);
+    }
+    return 0;
+}
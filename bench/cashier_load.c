@@ -0,0 +1,398 @@
+// Concurrent cashier load test against the in-process API.
+// Usage: cashier_load [-d seconds] [-q stock] [cashiers ...]   (defaults: 5s, 1000, 8 32 128)
+// Each run starts from a fresh generated catalog in a temporary directory and
+// lets N cashier threads run a mix of book and customer lookups, customer
+// registrations and basket checkouts for the given time. Results are printed as
+// one JSON object per line, including whether stock levels add up afterwards.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "../src/sales/sales.h"
+#include "../src/sales/sales_stats.h"
+#include "../src/book/book_index.h"
+#include "../src/metrics/lock_profile.h"
+#include "../src/metrics/trace.h"
+#include "../tools/datagen/datagen.h"
+
+#define MAX_CASHIERS 256
+#define SAMPLES_PER_CASHIER 4096 // Latency samples kept per cashier and kind
+#define INITIAL_CUSTOMERS 50     // Leaves room for registrations up to MAX_CUSTOMERS
+#define MAX_ITEMS_PER_BASKET 3
+
+// Operation mix, in percent of cashier actions
+#define MIX_SEARCH_ISBN 40
+#define MIX_SEARCH_TITLE 10
+#define MIX_LOOKUP_CUSTOMER 10
+#define MIX_REGISTER 5 // The remainder are checkouts
+
+// Shared store state for one run
+static Book storeBooks[MAX_BOOKS];
+static int storeNumBooks;
+static int initialStock[MAX_BOOKS];
+static long unitsSold[MAX_BOOKS]; // Per book, counted by the driver from accepted baskets
+static Customer storeCustomers[MAX_CUSTOMERS];
+static int storeNumCustomers;
+static Sale storeSales[MAX_SALES];
+static int storeNumSales;
+static long historyRotations; // Times the bounded sales history was closed out
+static int nextCustomerID;
+static volatile int running;
+
+typedef struct {
+    double samples[SAMPLES_PER_CASHIER]; // Seconds per operation
+    long count;
+} Latencies;
+
+typedef struct {
+    pthread_t thread;
+    uint64_t rng;
+    long lookups;
+    long registrations;
+    long rejectedRegistrations;
+    long checkouts;
+    long rejectedCheckouts;
+    Latencies checkoutLatency;
+    Latencies lookupLatency;
+} Cashier;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t nextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static void record(Latencies *latencies, double start) {
+    if (latencies->count < SAMPLES_PER_CASHIER) {
+        latencies->samples[latencies->count++] = nowSeconds() - start;
+    }
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *samples, long count, double fraction) {
+    return count > 0 ? samples[(long)(fraction * (count - 1) + 0.5)] : 0.0;
+}
+
+// The history is capped at MAX_SALES, so a register closes it out (as at end of
+// day) when the next basket might not fit. Totals in salesStats carry on.
+static void rotateHistoryIfFull(void) {
+    PROFILED_LOCK(&bookMutex);
+    if (storeNumSales + MAX_ITEMS_PER_BASKET > MAX_SALES) {
+        storeNumSales = 0;
+        historyRotations++;
+    }
+    PROFILED_UNLOCK(&bookMutex);
+}
+
+// Picks a registered customer under dataMutex, since registrations append concurrently;
+// numCustomers gets the count seen (slots below it are never rewritten during a run)
+static int pickCustomer(Cashier *cashier, int *numCustomers) {
+    PROFILED_LOCK(&dataMutex);
+    *numCustomers = storeNumCustomers;
+    int customerID = storeCustomers[nextRandom(&cashier->rng) % *numCustomers].customerID;
+    PROFILED_UNLOCK(&dataMutex);
+    return customerID;
+}
+
+static void checkout(Cashier *cashier) {
+    int numCustomers;
+    int customerID = pickCustomer(cashier, &numCustomers);
+    int numItems = 1 + (int)(nextRandom(&cashier->rng) % MAX_ITEMS_PER_BASKET);
+    BasketItem items[MAX_ITEMS_PER_BASKET];
+    int bookIndex[MAX_ITEMS_PER_BASKET];
+    for (int i = 0; i < numItems; i++) {
+        bookIndex[i] = (int)(nextRandom(&cashier->rng) % storeNumBooks);
+        items[i].ISBN = storeBooks[bookIndex[i]].ISBN;
+        items[i].quantity = 1 + (int)(nextRandom(&cashier->rng) % 2);
+    }
+
+    rotateHistoryIfFull();
+    double start = nowSeconds();
+    int recorded = processBasket(storeBooks, storeNumBooks, storeCustomers, numCustomers, storeSales, &storeNumSales,
+                                 customerID, items, numItems);
+    record(&cashier->checkoutLatency, start);
+
+    if (recorded < 0) {
+        cashier->rejectedCheckouts++; // Out of stock, or the history filled up first
+        return;
+    }
+    cashier->checkouts++;
+    for (int i = 0; i < numItems; i++) {
+        __atomic_fetch_add(&unitsSold[bookIndex[i]], items[i].quantity, __ATOMIC_RELAXED);
+    }
+}
+
+static void registerCustomer(Cashier *cashier) {
+    Customer customer;
+    customer.customerID = __atomic_fetch_add(&nextCustomerID, 1, __ATOMIC_RELAXED);
+    snprintf(customer.name, sizeof(customer.name), "Walk In %d", customer.customerID);
+    snprintf(customer.phone, sizeof(customer.phone), "555%07d", customer.customerID % 10000000);
+
+    if (insertCustomer(storeCustomers, &storeNumCustomers, &customer) == 0) {
+        cashier->registrations++;
+    } else {
+        cashier->rejectedRegistrations++; // Customer table full
+    }
+}
+
+static void lookup(Cashier *cashier, int action) {
+    const Book *book = &storeBooks[nextRandom(&cashier->rng) % storeNumBooks];
+    double start = nowSeconds();
+    if (action < MIX_SEARCH_ISBN) {
+        searchBookByISBN(storeBooks, storeNumBooks, book->ISBN);
+    } else if (action < MIX_SEARCH_ISBN + MIX_SEARCH_TITLE) {
+        char query[8];
+        strncpy(query, book->title, 4);
+        query[4] = '\0';
+        free(searchBookByTitle(storeBooks, storeNumBooks, query));
+    } else {
+        int numCustomers;
+        int customerID = pickCustomer(cashier, &numCustomers);
+        searchCustomerByID(storeCustomers, numCustomers, customerID);
+    }
+    record(&cashier->lookupLatency, start);
+    cashier->lookups++;
+}
+
+static void *cashierThread(void *arg) {
+    Cashier *cashier = (Cashier *)arg;
+    while (running) {
+        int action = (int)(nextRandom(&cashier->rng) % 100);
+        if (action < MIX_SEARCH_ISBN + MIX_SEARCH_TITLE + MIX_LOOKUP_CUSTOMER) {
+            lookup(cashier, action);
+        } else if (action < MIX_SEARCH_ISBN + MIX_SEARCH_TITLE + MIX_LOOKUP_CUSTOMER + MIX_REGISTER) {
+            registerCustomer(cashier);
+        } else {
+            checkout(cashier);
+        }
+    }
+    return NULL;
+}
+
+// Fresh catalog and customers for a run; returns 0 on success
+static int prepareStore(int stock) {
+    DatagenConfig config;
+    defaultDatagenConfig(&config);
+    config.numBooks = MAX_BOOKS - 1; // One below the cap: the loader warns on reaching it
+    config.numCustomers = INITIAL_CUSTOMERS;
+    config.numSales = 0;
+    config.outDir = "data"; // Our own scratch directory, regenerated per run
+    config.overwrite = 1;
+    if (generateDataset(&config) != 0) {
+        return -1;
+    }
+    unlink(SALES_STATS_DATA_FILE);
+
+    loadBooks(storeBooks, &storeNumBooks);
+    loadCustomers(storeCustomers, &storeNumCustomers);
+    if (storeNumBooks == 0 || storeNumCustomers == 0) {
+        fprintf(stderr, "Error: Generated dataset did not load.\n");
+        return -1;
+    }
+
+    nextCustomerID = 1;
+    for (int i = 0; i < storeNumCustomers; i++) {
+        if (storeCustomers[i].customerID >= nextCustomerID) {
+            nextCustomerID = storeCustomers[i].customerID + 1;
+        }
+    }
+    for (int i = 0; i < storeNumBooks; i++) {
+        storeBooks[i].quantity = stock;
+        initialStock[i] = stock;
+        unitsSold[i] = 0;
+    }
+    rebuildCatalogIndex(storeBooks, storeNumBooks);
+    saveBooks(storeBooks, storeNumBooks);
+    storeNumSales = 0;
+    historyRotations = 0;
+    resetSalesStats(&salesStats);
+    return 0;
+}
+
+// Stock must never go negative, must drop by exactly what the registers sold,
+// and must agree with the running sales totals.
+static int stockConsistent(long *mismatches) {
+    *mismatches = 0;
+    for (int i = 0; i < storeNumBooks; i++) {
+        const BookTotals *totals = getBookTotals(&salesStats, storeBooks[i].ISBN);
+        long tracked = totals ? totals->unitsSold : 0;
+        if (storeBooks[i].quantity < 0 || initialStock[i] - storeBooks[i].quantity != unitsSold[i]
+            || tracked != unitsSold[i]) {
+            (*mismatches)++;
+        }
+    }
+    return *mismatches == 0;
+}
+
+static void runCashiers(int numCashiers, double seconds, int stock) {
+    if (prepareStore(stock) != 0) {
+        return;
+    }
+
+    Cashier *cashiers = calloc(numCashiers, sizeof(Cashier));
+    if (!cashiers) {
+        perror("Memory allocation failed");
+        return;
+    }
+
+    // Rejections are expected under load; keep their messages off the terminal
+    fflush(stderr);
+    int savedStderr = dup(STDERR_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull >= 0) {
+        dup2(devNull, STDERR_FILENO);
+        close(devNull);
+    }
+
+    running = 1;
+    int started = 0;
+    double start = nowSeconds();
+    for (; started < numCashiers; started++) {
+        cashiers[started].rng = 0x5EEDull * (started + 1);
+        if (pthread_create(&cashiers[started].thread, NULL, cashierThread, &cashiers[started]) != 0) {
+            break;
+        }
+    }
+    struct timespec duration = {(time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)};
+    nanosleep(&duration, NULL);
+    running = 0;
+    for (int i = 0; i < started; i++) {
+        pthread_join(cashiers[i].thread, NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    fflush(stderr);
+    if (savedStderr >= 0) {
+        dup2(savedStderr, STDERR_FILENO);
+        close(savedStderr);
+    }
+    if (started < numCashiers) {
+        fprintf(stderr, "Warning: Only %d of %d cashiers started.\n", started, numCashiers);
+    }
+
+    long lookups = 0, registrations = 0, rejectedRegistrations = 0, checkouts = 0, rejectedCheckouts = 0;
+    long checkoutSamples = 0, lookupSamples = 0;
+    for (int i = 0; i < started; i++) {
+        lookups += cashiers[i].lookups;
+        registrations += cashiers[i].registrations;
+        rejectedRegistrations += cashiers[i].rejectedRegistrations;
+        checkouts += cashiers[i].checkouts;
+        rejectedCheckouts += cashiers[i].rejectedCheckouts;
+        checkoutSamples += cashiers[i].checkoutLatency.count;
+        lookupSamples += cashiers[i].lookupLatency.count;
+    }
+
+    // Pool every cashier's samples for the percentiles
+    double *checkoutAll = malloc((checkoutSamples + 1) * sizeof(double));
+    double *lookupAll = malloc((lookupSamples + 1) * sizeof(double));
+    if (!checkoutAll || !lookupAll) {
+        perror("Memory allocation failed");
+        free(checkoutAll);
+        free(lookupAll);
+        free(cashiers);
+        return;
+    }
+    long c = 0, l = 0;
+    for (int i = 0; i < started; i++) {
+        memcpy(&checkoutAll[c], cashiers[i].checkoutLatency.samples, cashiers[i].checkoutLatency.count * sizeof(double));
+        c += cashiers[i].checkoutLatency.count;
+        memcpy(&lookupAll[l], cashiers[i].lookupLatency.samples, cashiers[i].lookupLatency.count * sizeof(double));
+        l += cashiers[i].lookupLatency.count;
+    }
+    qsort(checkoutAll, checkoutSamples, sizeof(double), compareDoubles);
+    qsort(lookupAll, lookupSamples, sizeof(double), compareDoubles);
+
+    long mismatches;
+    int consistent = stockConsistent(&mismatches);
+    printf("{\"cashiers\":%d,\"seconds\":%.2f,\"checkouts\":%ld,\"checkouts_per_sec\":%.1f,"
+           "\"rejected_checkouts\":%ld,\"lookups\":%ld,\"lookups_per_sec\":%.1f,"
+           "\"registrations\":%ld,\"rejected_registrations\":%ld,\"history_rotations\":%ld,"
+           "\"checkout_p50_us\":%.1f,\"checkout_p99_us\":%.1f,\"checkout_p999_us\":%.1f,"
+           "\"lookup_p50_us\":%.1f,\"lookup_p99_us\":%.1f,"
+           "\"stock_consistent\":%s,\"stock_mismatches\":%ld}\n",
+           started, elapsed, checkouts, checkouts / elapsed, rejectedCheckouts, lookups, lookups / elapsed,
+           registrations, rejectedRegistrations, historyRotations,
+           percentile(checkoutAll, checkoutSamples, 0.50) * 1e6, percentile(checkoutAll, checkoutSamples, 0.99) * 1e6,
+           percentile(checkoutAll, checkoutSamples, 0.999) * 1e6,
+           percentile(lookupAll, lookupSamples, 0.50) * 1e6, percentile(lookupAll, lookupSamples, 0.99) * 1e6,
+           consistent ? "true" : "false", mismatches);
+    fflush(stdout);
+
+    free(checkoutAll);
+    free(lookupAll);
+    free(cashiers);
+}
+
+static void removeDataset(void) {
+    const char *files[] = {"data/books.csv", "data/customers.csv", "data/sales.csv", SALES_STATS_DATA_FILE};
+    for (int i = 0; i < (int)(sizeof(files) / sizeof(files[0])); i++) {
+        unlink(files[i]);
+    }
+    rmdir("data");
+}
+
+int main(int argc, char *argv[]) {
+    initTracing(); // BOOKSTORE_TRACE=<file> records every cashier's spans
+    double seconds = 5.0;
+    int stock = 1000;
+    int option;
+    while ((option = getopt(argc, argv, "d:q:")) != -1) {
+        switch (option) {
+            case 'd':
+                seconds = atof(optarg);
+                break;
+            case 'q':
+                stock = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-d seconds] [-q stock] [cashiers ...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (seconds <= 0 || stock < 0) {
+        fprintf(stderr, "Error: Duration must be positive and stock non-negative.\n");
+        return 1;
+    }
+
+    // The loaders use fixed relative paths, so run inside a scratch directory
+    char workDir[] = "/tmp/cashier_load.XXXXXX";
+    if (!mkdtemp(workDir) || chdir(workDir) != 0 || mkdir("data", 0755) != 0) {
+        perror("Error preparing load test directory");
+        return 1;
+    }
+
+    int defaultCashiers[] = {8, 32, 128};
+    int numRuns = optind < argc ? argc - optind : 3;
+    for (int i = 0; i < numRuns; i++) {
+        int numCashiers = optind < argc ? atoi(argv[optind + i]) : defaultCashiers[i];
+        if (numCashiers <= 0 || numCashiers > MAX_CASHIERS) {
+            fprintf(stderr, "Error: Cashier counts must be between 1 and %d.\n", MAX_CASHIERS);
+            continue;
+        }
+        runCashiers(numCashiers, seconds, stock);
+    }
+
+    dumpLockProfile(stderr); // Where the registers queued (needs -DLOCK_PROFILING=ON)
+
+    removeDataset();
+    if (chdir("/") == 0) {
+        rmdir(workDir);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Throughput benchmark for the streaming report exporter.
+// Usage: report_bench [rows] [output-path]   (defaults: 1000000, /dev/null)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/sales/sales.h"
+#include "../src/sales/sales_report.h"
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Baseline: the same CSV rows through one fprintf per row
+static long exportSalesStdio(const Sale *sales, int numSales, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Error opening output");
+        return -1;
+    }
+    fprintf(file, "sale_id,customer_id,isbn,quantity,total_price,timestamp\n");
+    for (int i = 0; i < numSales; i++) {
+        fprintf(file, "%d,%d,%d,%d,%.2f,%ld\n", sales[i].saleID, sales[i].customerID, sales[i].ISBN,
+                sales[i].quantity, sales[i].totalPrice, (long)sales[i].timestamp);
+    }
+    fclose(file);
+    return numSales;
+}
+
+static void report(const char *name, long rows, double seconds) {
+    printf("{\"bench\":\"%s\",\"rows\":%ld,\"seconds\":%.4f,\"rows_per_sec\":%.0f}\n",
+           name, rows, seconds, rows / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    int numSales = argc > 1 ? atoi(argv[1]) : 1000000;
+    const char *path = argc > 2 ? argv[2] : "/dev/null";
+    if (numSales <= 0) {
+        fprintf(stderr, "Error: Row count must be positive.\n");
+        return 1;
+    }
+
+    Sale *sales = malloc((size_t)numSales * sizeof(Sale));
+    if (!sales) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+    srand(42);
+    for (int i = 0; i < numSales; i++) {
+        sales[i].saleID = i + 1;
+        sales[i].customerID = 1 + rand() % 100000;
+        sales[i].ISBN = 100000 + rand() % 900000;
+        sales[i].quantity = 1 + rand() % 5;
+        sales[i].totalPrice = sales[i].quantity * (1.0f + (rand() % 9900) / 100.0f);
+        sales[i].timestamp = 1700000000 + i;
+    }
+
+    ReportFormat formats[] = {REPORT_CSV, REPORT_JSON};
+    const char *names[] = {"export_csv", "export_json"};
+    for (int f = 0; f < 2; f++) {
+        double start = nowSeconds();
+        long rows = exportSalesToFile(sales, numSales, formats[f], path);
+        double elapsed = nowSeconds() - start;
+        if (rows < 0) {
+            return 1;
+        }
+        report(names[f], rows, elapsed);
+    }
+
+    double start = nowSeconds();
+    long rows = exportSalesStdio(sales, numSales, path);
+    if (rows < 0) {
+        return 1;
+    }
+    report("fprintf_csv_baseline", rows, nowSeconds() - start);
+
+    free(sales);
+    return 0;
+}
@@ -0,0 +1,446 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch.h"
+#include "../sales/sales_stats.h"
+#include "../sales/sales_report.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/mem_account.h"
+#include "../listing/listing.h"
+#include "../book/book_index.h"
+#include "../book/book_fuzzy.h"
+#include "../customer/customer_index.h"
+
+#define MAX_BATCH_LINE 512
+
+static void writeError(ReportWriter *out, long line, const char *reason) {
+    reportWriteString(out, "ERR ");
+    reportWriteInt(out, line);
+    reportWrite(out, " ", 1);
+    reportWriteString(out, reason);
+    reportWrite(out, "\n", 1);
+}
+
+static void writeBookRow(ReportWriter *out, const Book *book) {
+    reportWriteInt(out, book->ISBN);
+    reportWrite(out, "|", 1);
+    reportWriteString(out, book->title);
+    reportWrite(out, "|", 1);
+    reportWriteString(out, book->author);
+    reportWrite(out, "|", 1);
+    reportWritePrice(out, book->price);
+    reportWrite(out, "|", 1);
+    reportWriteInt(out, book->quantity);
+}
+
+static void writeCustomerRow(ReportWriter *out, const Customer *customer) {
+    reportWriteInt(out, customer->customerID);
+    reportWrite(out, "|", 1);
+    reportWriteString(out, customer->name);
+    reportWrite(out, "|", 1);
+    reportWriteString(out, customer->phone);
+}
+
+static void writeSaleRow(ReportWriter *out, const Sale *sale) {
+    reportWriteInt(out, sale->saleID);
+    reportWrite(out, "|", 1);
+    reportWriteInt(out, sale->customerID);
+    reportWrite(out, "|", 1);
+    reportWriteInt(out, sale->ISBN);
+    reportWrite(out, "|", 1);
+    reportWriteInt(out, sale->quantity);
+    reportWrite(out, "|", 1);
+    reportWritePrice(out, sale->totalPrice);
+    reportWrite(out, "|", 1);
+    reportWriteInt(out, (long long)sale->timestamp);
+}
+
+static int batchAddBook(ReportWriter *out, BatchContext *context, const char *args) {
+    Book book;
+    if (sscanf(args, "%d|%99[^|]|%49[^|]|%f|%d", &book.ISBN, book.title, book.author,
+               &book.price, &book.quantity) != 5) {
+        return -1;
+    }
+    if (insertBook(context->books, context->numBooks, &book) != 0) {
+        return -1;
+    }
+    reportWriteString(out, "OK\n");
+    return 0;
+}
+
+static int batchAddCustomer(ReportWriter *out, BatchContext *context, const char *args) {
+    Customer customer;
+    if (sscanf(args, "%d|%49[^|]|%19s", &customer.customerID, customer.name, customer.phone) != 3) {
+        return -1;
+    }
+    if (insertCustomer(context->customers, context->numCustomers, &customer) != 0) {
+        return -1;
+    }
+    reportWriteString(out, "OK\n");
+    return 0;
+}
+
+// Check out the items and report the new sale IDs and the total
+static int batchCheckout(ReportWriter *out, BatchContext *context, int customerID, const BasketItem *items, int numItems) {
+    int recorded = processBasket(context->books, *context->numBooks, context->customers, *context->numCustomers,
+                                 context->sales, context->numSales, customerID, items, numItems);
+    if (recorded <= 0) {
+        return -1;
+    }
+
+    const Sale *first = &context->sales[*context->numSales - recorded];
+    double total = 0.0;
+    for (int i = 0; i < recorded; i++) {
+        total += first[i].totalPrice;
+    }
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, first->saleID);
+    reportWrite(out, " ", 1);
+    reportWritePrice(out, total);
+    reportWrite(out, "\n", 1);
+    return 0;
+}
+
+static int batchSale(ReportWriter *out, BatchContext *context, const char *args) {
+    int customerID;
+    BasketItem item;
+    if (sscanf(args, "%d %d %d", &customerID, &item.ISBN, &item.quantity) != 3) {
+        return -1;
+    }
+    return batchCheckout(out, context, customerID, &item, 1);
+}
+
+static int batchBasket(ReportWriter *out, BatchContext *context, const char *args) {
+    BasketItem items[MAX_BASKET_ITEMS];
+    int customerID, consumed, numItems = 0;
+    if (sscanf(args, "%d%n", &customerID, &consumed) != 1) {
+        return -1;
+    }
+    args += consumed;
+    while (numItems < MAX_BASKET_ITEMS &&
+           sscanf(args, " %d:%d%n", &items[numItems].ISBN, &items[numItems].quantity, &consumed) == 2) {
+        numItems++;
+        args += consumed;
+    }
+    if (numItems == 0 || args[strspn(args, " \t")] != '\0') {
+        return -1; // No items, or trailing garbage / too many items
+    }
+    return batchCheckout(out, context, customerID, items, numItems);
+}
+
+static int batchFindISBN(ReportWriter *out, BatchContext *context, const char *args) {
+    int ISBN;
+    if (sscanf(args, "%d", &ISBN) != 1) {
+        return -1;
+    }
+    const Book *book = searchBookByISBN(context->books, *context->numBooks, ISBN);
+    if (!book) {
+        return -1;
+    }
+    reportWriteString(out, "OK ");
+    writeBookRow(out, book);
+    reportWrite(out, "\n", 1);
+    return 0;
+}
+
+// Result: "OK <count>" followed by one row per matching book
+static int batchFindTitle(ReportWriter *out, BatchContext *context, const char *args) {
+    if (*args == '\0') {
+        return -1;
+    }
+    Book *found = searchBookByTitle(context->books, *context->numBooks, args);
+    int count = 0;
+    while (found && found[count].ISBN != 0) {
+        count++;
+    }
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, count);
+    reportWrite(out, "\n", 1);
+    for (int i = 0; i < count; i++) {
+        writeBookRow(out, &found[i]);
+        reportWrite(out, "\n", 1);
+    }
+    free(found);
+    return 0;
+}
+
+// Result: "OK <count>" followed by one row per indexed match, in index order
+static void writeBookMatches(ReportWriter *out, BatchContext *context, const int *ISBNs, int count) {
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, count);
+    reportWrite(out, "\n", 1);
+    for (int i = 0; i < count; i++) {
+        const Book *book = searchBookByISBN(context->books, *context->numBooks, ISBNs[i]);
+        if (book) {
+            writeBookRow(out, book);
+            reportWrite(out, "\n", 1);
+        }
+    }
+}
+
+static int batchPriceRange(ReportWriter *out, BatchContext *context, const char *args) {
+    float minPrice, maxPrice;
+    int matches[MAX_BOOKS];
+    if (sscanf(args, "%f %f", &minPrice, &maxPrice) != 2 || minPrice > maxPrice) {
+        return -1;
+    }
+    writeBookMatches(out, context, matches, findBooksByPriceRange(minPrice, maxPrice, matches, MAX_BOOKS));
+    return 0;
+}
+
+static int batchLowStock(ReportWriter *out, BatchContext *context, const char *args) {
+    int threshold = LOW_STOCK_THRESHOLD;
+    int matches[MAX_BOOKS];
+    if (*args != '\0' && (sscanf(args, "%d", &threshold) != 1 || threshold <= 0)) {
+        return -1;
+    }
+    writeBookMatches(out, context, matches, findLowStockBooks(threshold, matches, MAX_BOOKS));
+    return 0;
+}
+
+static int batchFindAuthor(ReportWriter *out, BatchContext *context, const char *args) {
+    int matches[MAX_BOOKS];
+    if (*args == '\0') {
+        return -1;
+    }
+    writeBookMatches(out, context, matches, findBooksByAuthorPrefix(args, matches, MAX_BOOKS));
+    return 0;
+}
+
+// Result: "OK <count>" followed by one "<distance>|<book row>" line per match, closest first
+static int batchFindTitleFuzzy(ReportWriter *out, BatchContext *context, const char *args) {
+    int maxErrors, offset;
+    TitleMatch matches[MAX_BOOKS];
+    if (sscanf(args, "%d %n", &maxErrors, &offset) != 1 || maxErrors < 0 || args[offset] == '\0') {
+        return -1;
+    }
+    int count = searchBooksByTitleFuzzy(context->books, *context->numBooks, args + offset, maxErrors, 0,
+                                        matches, MAX_BOOKS);
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, count);
+    reportWrite(out, "\n", 1);
+    for (int i = 0; i < count; i++) {
+        const Book *book = searchBookByISBN(context->books, *context->numBooks, matches[i].ISBN);
+        if (book) {
+            reportWriteInt(out, matches[i].distance);
+            reportWrite(out, "|", 1);
+            writeBookRow(out, book);
+            reportWrite(out, "\n", 1);
+        }
+    }
+    return 0;
+}
+
+static int batchFindCustomer(ReportWriter *out, BatchContext *context, const char *args) {
+    int customerID;
+    if (sscanf(args, "%d", &customerID) != 1) {
+        return -1;
+    }
+    const Customer *customer = searchCustomerByID(context->customers, *context->numCustomers, customerID);
+    if (!customer) {
+        return -1;
+    }
+    reportWriteString(out, "OK ");
+    writeCustomerRow(out, customer);
+    reportWrite(out, "\n", 1);
+    return 0;
+}
+
+static int batchFindPhone(ReportWriter *out, BatchContext *context, const char *args) {
+    if (*args == '\0') {
+        return -1;
+    }
+    const Customer *customer = searchCustomerByPhone(context->customers, *context->numCustomers, args);
+    if (!customer) {
+        return -1;
+    }
+    reportWriteString(out, "OK ");
+    writeCustomerRow(out, customer);
+    reportWrite(out, "\n", 1);
+    return 0;
+}
+
+// Result: "OK <count>" followed by one row per customer; prefix matches by ID,
+// or when there are none, typo-tolerant matches closest first
+static int batchFindName(ReportWriter *out, BatchContext *context, const char *args) {
+    int customerIDs[MAX_CUSTOMERS];
+    CustomerMatch matches[MAX_CUSTOMERS];
+    if (*args == '\0') {
+        return -1;
+    }
+    int count = findCustomersByNamePrefix(args, customerIDs, MAX_CUSTOMERS);
+    if (count == 0) {
+        count = findCustomersByNameFuzzy(args, NAME_FUZZY_MAX_DISTANCE, matches, MAX_CUSTOMERS);
+        for (int i = 0; i < count; i++) {
+            customerIDs[i] = matches[i].customerID;
+        }
+    }
+
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, count);
+    reportWrite(out, "\n", 1);
+    for (int i = 0; i < count; i++) {
+        const Customer *customer = searchCustomerByID(context->customers, *context->numCustomers, customerIDs[i]);
+        if (customer) {
+            writeCustomerRow(out, customer);
+            reportWrite(out, "\n", 1);
+        }
+    }
+    return 0;
+}
+
+// Result: "OK <count> <nextKey>" followed by one row per record, ordered by key;
+// pass nextKey back as afterKey for the following page (0 when exhausted)
+static int batchList(ReportWriter *out, BatchContext *context, const char *args) {
+    char kind[16];
+    int afterKey, limit;
+    if (sscanf(args, "%15s %d %d", kind, &afterKey, &limit) != 3 || limit <= 0 || limit > LIST_MAX_PAGE_SIZE) {
+        return -1;
+    }
+
+    size_t recordSize = sizeof(Book) > sizeof(Customer) ? sizeof(Book) : sizeof(Customer);
+    recordSize = recordSize > sizeof(Sale) ? recordSize : sizeof(Sale);
+    void *page = memAlloc(MEM_REPORTS, (size_t)limit * recordSize);
+    if (!page) {
+        return -1;
+    }
+
+    ListCursor cursor;
+    resumeListCursor(&cursor, limit, afterKey);
+    int count;
+    if (strcmp(kind, "BOOKS") == 0) {
+        count = listBooksPage(context->books, context->numBooks, &cursor, page);
+    } else if (strcmp(kind, "CUSTOMERS") == 0) {
+        count = listCustomersPage(context->customers, context->numCustomers, &cursor, page);
+    } else if (strcmp(kind, "SALES") == 0) {
+        count = listSalesPage(context->sales, context->numSales, &cursor, page);
+    } else {
+        memFree(page);
+        return -1;
+    }
+
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, count);
+    reportWrite(out, " ", 1);
+    reportWriteInt(out, cursor.done ? 0 : cursor.lastKey);
+    reportWrite(out, "\n", 1);
+    for (int i = 0; i < count; i++) {
+        if (kind[0] == 'B') {
+            writeBookRow(out, &((Book *)page)[i]);
+        } else if (kind[0] == 'C') {
+            writeCustomerRow(out, &((Customer *)page)[i]);
+        } else {
+            writeSaleRow(out, &((Sale *)page)[i]);
+        }
+        reportWrite(out, "\n", 1);
+    }
+    memFree(page);
+    return 0;
+}
+
+static int batchTotals(ReportWriter *out) {
+    reportWriteString(out, "OK ");
+    reportWriteInt(out, salesStats.numSales);
+    reportWrite(out, " ", 1);
+    reportWriteInt(out, salesStats.unitsSold);
+    reportWrite(out, " ", 1);
+    reportWritePrice(out, salesStats.revenue);
+    reportWrite(out, "\n", 1);
+    return 0;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int runBatch(FILE *input, BatchContext *context) {
+    ReportWriter out;
+    if (openReportWriter(&out, STDOUT_FILENO) != 0) {
+        return -1;
+    }
+
+    char line[MAX_BATCH_LINE];
+    long lineNumber = 0, commands = 0;
+    int failures = 0;
+    double start = nowSeconds();
+
+    while (fgets(line, sizeof(line), input)) {
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *command = line + strspn(line, " \t");
+        if (*command == '\0' || *command == '#') {
+            continue;
+        }
+        commands++;
+
+        // Split "COMMAND args"
+        char *args = command + strcspn(command, " \t");
+        if (*args != '\0') {
+            *args++ = '\0';
+            args += strspn(args, " \t");
+        }
+
+        int status;
+        if (strcmp(command, "ADD_BOOK") == 0) {
+            status = batchAddBook(&out, context, args);
+        } else if (strcmp(command, "ADD_CUSTOMER") == 0) {
+            status = batchAddCustomer(&out, context, args);
+        } else if (strcmp(command, "SALE") == 0) {
+            status = batchSale(&out, context, args);
+        } else if (strcmp(command, "BASKET") == 0) {
+            status = batchBasket(&out, context, args);
+        } else if (strcmp(command, "FIND_ISBN") == 0) {
+            status = batchFindISBN(&out, context, args);
+        } else if (strcmp(command, "FIND_TITLE") == 0) {
+            status = batchFindTitle(&out, context, args);
+        } else if (strcmp(command, "FIND_TITLE_FUZZY") == 0) {
+            status = batchFindTitleFuzzy(&out, context, args);
+        } else if (strcmp(command, "FIND_AUTHOR") == 0) {
+            status = batchFindAuthor(&out, context, args);
+        } else if (strcmp(command, "PRICE_RANGE") == 0) {
+            status = batchPriceRange(&out, context, args);
+        } else if (strcmp(command, "LOW_STOCK") == 0) {
+            status = batchLowStock(&out, context, args);
+        } else if (strcmp(command, "FIND_CUSTOMER") == 0) {
+            status = batchFindCustomer(&out, context, args);
+        } else if (strcmp(command, "FIND_PHONE") == 0) {
+            status = batchFindPhone(&out, context, args);
+        } else if (strcmp(command, "FIND_NAME") == 0) {
+            status = batchFindName(&out, context, args);
+        } else if (strcmp(command, "LIST") == 0) {
+            status = batchList(&out, context, args);
+        } else if (strcmp(command, "TOTALS") == 0) {
+            status = batchTotals(&out);
+        } else if (strcmp(command, "STATS") == 0) {
+            flushReportWriter(&out); // Keep the dump in order with earlier results
+            dumpOpLatencies(stdout);
+            dumpLockProfile(stdout);
+            status = 0;
+        } else if (strcmp(command, "MEM") == 0) {
+            flushReportWriter(&out);
+            dumpMemoryStats(stdout);
+            status = 0;
+        } else {
+            writeError(&out, lineNumber, "unknown command");
+            failures++;
+            continue;
+        }
+
+        if (status != 0) {
+            writeError(&out, lineNumber, command);
+            failures++;
+        }
+    }
+
+    closeReportWriter(&out);
+
+    double elapsed = nowSeconds() - start;
+    fprintf(stderr, "Batch: %ld commands, %d failed, %.3f s (%.0f ops/s)\n",
+            commands, failures, elapsed, elapsed > 0 ? commands / elapsed : 0.0);
+    return failures;
+}
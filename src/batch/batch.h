@@ -0,0 +1,41 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "../sales/sales.h"
+
+// The store data a batch run operates on (the same arrays the menus use)
+typedef struct {
+    Book *books;
+    int *numBooks;
+    Customer *customers;
+    int *numCustomers;
+    Sale *sales;
+    int *numSales;
+} BatchContext;
+
+// Function prototypes (declarations)
+// Executes one command per line with no menu rendering and writes one compact
+// result line per command to stdout ("OK ..." or "ERR <line> <reason>").
+// Blank lines and lines starting with '#' are skipped. Commands:
+//   ADD_BOOK <isbn>|<title>|<author>|<price>|<quantity>
+//   ADD_CUSTOMER <id>|<name>|<phone>
+//   SALE <customerID> <isbn> <quantity>
+//   BASKET <customerID> <isbn>:<quantity> [<isbn>:<quantity> ...]
+//   FIND_ISBN <isbn>
+//   FIND_TITLE <text>
+//   FIND_TITLE_FUZZY <maxErrors> <text>   (titles containing text within maxErrors edits, closest first)
+//   FIND_AUTHOR <prefix>      (author name or any word of it, case-insensitive)
+//   PRICE_RANGE <min> <max>   (books priced within the bounds, cheapest first)
+//   LOW_STOCK [threshold]     (books with fewer copies, lowest first; default 5)
+//   FIND_CUSTOMER <id>
+//   FIND_PHONE <phone>        (digits only are compared, so 555-123-4567 works)
+//   FIND_NAME <text>          (customers by name-word prefixes, else within a few typos)
+//   LIST <BOOKS|CUSTOMERS|SALES> <afterKey> <limit>   (one page, ordered by key)
+//   TOTALS
+//   STATS                (per-operation latency and lock contention tables)
+//   MEM                  (memory by subsystem)
+// Returns the number of commands that failed.
+int runBatch(FILE *input, BatchContext *context);
+
+#endif // BATCH_H
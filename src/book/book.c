@@ -3,6 +3,12 @@
 #include <string.h>
 #include <pthread.h>
 #include "book.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../render/render.h"
+#include "../listing/listing.h"
+#include "../metrics/mem_account.h"
+#include "book_index.h"
 
 #define BOOKS_DATA_FILE "data/books.csv"
 #define MAX_BOOKS 100
@@ -13,13 +19,15 @@ int numBooks = 0;
 pthread_mutex_t bookMutex = PTHREAD_MUTEX_INITIALIZER;
 
 void loadBooks(Book *books, int *numBooks) {
-    pthread_mutex_lock(&bookMutex);
+    OP_LATENCY_SCOPE(OP_LOAD_BOOKS);
+    PROFILED_LOCK(&bookMutex);
 
     FILE *file = fopen(BOOKS_DATA_FILE, "r");
     if (!file) {
         perror("Error opening books file for reading");
         *numBooks = 0;
-        pthread_mutex_unlock(&bookMutex);
+        rebuildCatalogIndex(books, 0);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
@@ -42,20 +50,24 @@ void loadBooks(Book *books, int *numBooks) {
     }
 
     fclose(file);
-    pthread_mutex_unlock(&bookMutex);
+    rebuildCatalogIndex(books, *numBooks);
+    PROFILED_UNLOCK(&bookMutex);
 }
 
 
 
 void saveBooks(const Book *books, int numBooks) {
+    OP_LATENCY_SCOPE(OP_SAVE_BOOKS);
     FILE *file = fopen(BOOKS_DATA_FILE, "w");
     if (!file) {
         perror("Error opening file for writing");
         return;
     }
 
+    // Same layout loadBooks reads back: a header row, then comma-separated fields
+    fprintf(file, "ISBN,Title,Author,Price,Quantity\n");
     for (int i = 0; i < numBooks; i++) {
-        fprintf(file, "%d %s %s %.2f %d\n", books[i].ISBN, books[i].title,
+        fprintf(file, "%d,%s,%s,%.2f,%d\n", books[i].ISBN, books[i].title,
                 books[i].author, books[i].price, books[i].quantity);
     }
     fclose(file);
@@ -64,11 +76,11 @@ void saveBooks(const Book *books, int numBooks) {
 // Book Operations
 
 void addBook(Book *books, int *numBooks) {
-    pthread_mutex_lock(&bookMutex);
+    PROFILED_LOCK(&bookMutex);
 
     if (*numBooks >= MAX_BOOKS) {
         printf("Error: Maximum number of books reached.\n");
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
@@ -78,7 +90,7 @@ void addBook(Book *books, int *numBooks) {
     if (scanf("%d", &newBook.ISBN) != 1) {
         fprintf(stderr, "Error: Invalid ISBN input.\n");
         while (getchar() != '\n'); // Clear input buffer
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
@@ -92,7 +104,7 @@ void addBook(Book *books, int *numBooks) {
     if (scanf("%f", &newBook.price) != 1 || newBook.price <= 0) {
         fprintf(stderr, "Error: Invalid price input.\n");
         while (getchar() != '\n');
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
@@ -100,20 +112,50 @@ void addBook(Book *books, int *numBooks) {
     if (scanf("%d", &newBook.quantity) != 1 || newBook.quantity <= 0) {
         fprintf(stderr, "Error: Invalid quantity input.\n");
         while (getchar() != '\n');
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
-    books[*numBooks] = newBook;
+    PROFILED_UNLOCK(&bookMutex);
+
+    if (insertBook(books, numBooks, &newBook) == 0) {
+        printf("Book added successfully!\n");
+    }
+}
+
+// Non-interactive add: validates, appends and saves; returns 0 on success, -1 on error
+int insertBook(Book *books, int *numBooks, const Book *newBook) {
+    OP_LATENCY_SCOPE(OP_INSERT_BOOK);
+    if (newBook->ISBN <= 0 || newBook->price <= 0 || newBook->quantity < 0) {
+        fprintf(stderr, "Error: Invalid book details.\n");
+        return -1;
+    }
+
+    PROFILED_LOCK(&bookMutex);
+
+    if (*numBooks >= MAX_BOOKS) {
+        fprintf(stderr, "Error: Maximum number of books reached.\n");
+        PROFILED_UNLOCK(&bookMutex);
+        return -1;
+    }
+    if (findBookIndex(books, *numBooks, newBook->ISBN) >= 0) {
+        fprintf(stderr, "Error: Book with ISBN %d already exists.\n", newBook->ISBN);
+        PROFILED_UNLOCK(&bookMutex);
+        return -1;
+    }
+
+    books[*numBooks] = *newBook;
+    indexAddBook(newBook);
     (*numBooks)++;
     saveBooks(books, *numBooks);
-    printf("Book added successfully!\n");
 
-    pthread_mutex_unlock(&bookMutex);
+    PROFILED_UNLOCK(&bookMutex);
+    return 0;
 }
 
 void editBook(Book *books, int numBooks, int ISBN) {
-    pthread_mutex_lock(&bookMutex); // Acquire lock
+    OP_LATENCY_SCOPE(OP_EDIT_BOOK);
+    PROFILED_LOCK(&bookMutex); // Acquire lock
 
     int found = 0;
     int index = -1;
@@ -127,11 +169,12 @@ void editBook(Book *books, int numBooks, int ISBN) {
 
     if (!found) {
         printf("Book with ISBN %d not found.\n", ISBN);
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return;
     }
 
     Book *bookToEdit = &books[index];
+    Book before = *bookToEdit;
 
     printf("\nCurrent Book Details:\n");
     displayBook(bookToEdit);
@@ -174,19 +217,22 @@ void editBook(Book *books, int numBooks, int ISBN) {
         }
     }
 
+    indexUpdateBook(&before, bookToEdit);
     saveBooks(books, numBooks);
     printf("Book edited successfully!\n");
 
-    pthread_mutex_unlock(&bookMutex); // Release lock
+    PROFILED_UNLOCK(&bookMutex); // Release lock
 }
 
 void deleteBook(Book *books, int *numBooks, int ISBN) {
-    pthread_mutex_lock(&bookMutex); // Acquire lock
+    OP_LATENCY_SCOPE(OP_DELETE_BOOK);
+    PROFILED_LOCK(&bookMutex); // Acquire lock
 
     int found = 0;
     for (int i = 0; i < *numBooks; i++) {
         if (books[i].ISBN == ISBN) {
             found = 1;
+            indexRemoveBook(&books[i]);
             // Shift remaining books to fill the gap
             for (int j = i; j < *numBooks - 1; j++) {
                 books[j] = books[j + 1];
@@ -202,11 +248,25 @@ void deleteBook(Book *books, int *numBooks, int ISBN) {
         printf("Book with ISBN %d not found.\n", ISBN);
     }
 
-    pthread_mutex_unlock(&bookMutex); // Release lock
+    PROFILED_UNLOCK(&bookMutex); // Release lock
+}
+
+// Index of the book with this ISBN, or -1 (no locking; caller holds bookMutex)
+int findBookIndex(const Book *books, int numBooks, int ISBN) {
+    for (int i = 0; i < numBooks; i++) {
+        if (books[i].ISBN == ISBN) {
+            return i;
+        }
+    }
+    return -1;
 }
 
 Book* searchBookByISBN(const Book *books, int numBooks, int ISBN) {
-    // ... (Implementation for searching a book by ISBN) ...
+    OP_LATENCY_SCOPE(OP_SEARCH_BOOK_ISBN);
+    PROFILED_LOCK(&bookMutex);
+    int index = findBookIndex(books, numBooks, ISBN);
+    PROFILED_UNLOCK(&bookMutex);
+    return index >= 0 ? (Book*)&books[index] : NULL;
 }
 
 #include <stdio.h>
@@ -218,16 +278,17 @@ Book* searchBookByISBN(const Book *books, int numBooks, int ISBN) {
 // ... (other includes and declarations) ...
 
 Book* searchBookByTitle(const Book *books, int numBooks, const char *title) {
-    pthread_mutex_lock(&bookMutex);
+    OP_LATENCY_SCOPE(OP_SEARCH_BOOK_TITLE);
+    PROFILED_LOCK(&bookMutex);
 
     Book *foundBooks = NULL;
     int count = 0;
 
-    // Allocate memory for potential matches (worst case: all books match)
-    foundBooks = malloc(numBooks * sizeof(Book));
+    // Allocate memory for potential matches (worst case: all books match, plus the sentinel)
+    foundBooks = malloc((numBooks + 1) * sizeof(Book));
     if (!foundBooks) {
         perror("Memory allocation failed");
-        pthread_mutex_unlock(&bookMutex);
+        PROFILED_UNLOCK(&bookMutex);
         return NULL;
     }
 
@@ -262,14 +323,66 @@ Book* searchBookByTitle(const Book *books, int numBooks, const char *title) {
         foundBooks[count].ISBN = 0;
     }
 
-    pthread_mutex_unlock(&bookMutex);
+    PROFILED_UNLOCK(&bookMutex);
     return foundBooks;
 }
 
 void displayBook(const Book *book) {
-    // ... (Implementation for displaying a book's details) ...
+    ReportWriter out;
+    if (beginStdoutRender(&out) == 0) {
+        renderBook(&out, book);
+        endStdoutRender(&out);
+    }
 }
 
-void displayAllBooks(const Book *books, int numBooks) {
-    // ... (Implementation for displaying all books) ...
+// Function to display a result set of books through one render writer
+void displayBookList(const Book *list, int count) {
+    ReportWriter out;
+    if (beginStdoutRender(&out) != 0) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        renderBook(&out, &list[i]);
+    }
+    endStdoutRender(&out);
+}
+
+// Function to display the books with the given ISBNs (skipping any since deleted),
+// looked up under one hold of bookMutex and written through one render writer
+void displayBooksByISBN(const Book *books, int numBooks, const int *ISBNs, int count) {
+    ReportWriter out;
+    if (beginStdoutRender(&out) != 0) {
+        return;
+    }
+    PROFILED_LOCK(&bookMutex);
+    for (int i = 0; i < count; i++) {
+        int index = findBookIndex(books, numBooks, ISBNs[i]);
+        if (index >= 0) {
+            renderBook(&out, &books[index]);
+        }
+    }
+    PROFILED_UNLOCK(&bookMutex);
+    endStdoutRender(&out);
+}
+
+// Pages through the catalog with a cursor; bookMutex is held only while a page is copied
+void displayAllBooks(const Book *books, const int *numBooks) {
+    ReportWriter out;
+    Book *page = memAlloc(MEM_REPORTS, RENDER_PAGE_ROWS * sizeof(Book));
+    if (!page || beginStdoutRender(&out) != 0) {
+        memFree(page);
+        return;
+    }
+
+    ListCursor cursor;
+    initListCursor(&cursor, RENDER_PAGE_ROWS, 0);
+    int count = listBooksPage(books, numBooks, &cursor, page);
+    reportWriteString(&out, count == 0 ? "No books found.\n" : "\nAll Books:\n");
+    for (; count > 0; count = listBooksPage(books, numBooks, &cursor, page)) {
+        for (int i = 0; i < count; i++) {
+            renderBook(&out, &page[i]);
+        }
+    }
+    endStdoutRender(&out);
+    memFree(page);
 }
@@ -1,9 +1,9 @@
 #ifndef BOOK_H
 #define BOOK_H
 
-#include "../book/book.h"
-#include "../customer/customer.h"
+#include <pthread.h>
 
+#define MAX_BOOKS 100
 #define MAX_TITLE_LENGTH 100
 #define MAX_AUTHOR_LENGTH 50
 
@@ -16,14 +16,23 @@ typedef struct {
     int quantity;
 } Book;
 
+extern Book books[MAX_BOOKS]; // The store catalog (defined in book.c)
+extern int numBooks;
+extern pthread_mutex_t bookMutex; // Guards the book array and its stock levels
+
 // Function prototypes (declarations)
 void addBook(Book *books, int *numBooks);
+int insertBook(Book *books, int *numBooks, const Book *newBook);
 void editBook(Book *books, int numBooks, int ISBN); // Updated prototype
 void deleteBook(Book *books, int *numBooks, int ISBN);
 Book* searchBookByISBN(const Book *books, int numBooks, int ISBN);
+int findBookIndex(const Book *books, int numBooks, int ISBN); // Caller holds bookMutex
 Book* searchBookByTitle(const Book *books, int numBooks, const char *title);
 void displayBook(const Book *book);
-void displayAllBooks(const Book *books, int numBooks); // Added numBooks parameter
+void displayBookList(const Book *list, int count);
+void displayBooksByISBN(const Book *books, int numBooks, const int *ISBNs, int count);
+void displayAllBooks(const Book *books, const int *numBooks); // Count read under bookMutex
 void loadBooks(Book *books, int *numBooks);
+void saveBooks(const Book *books, int numBooks);
 
 #endif // BOOK_H
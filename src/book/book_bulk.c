@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <limits.h>
+#include <pthread.h>
+#include "book_bulk.h"
+#include "book_index.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/mem_account.h"
+
+// Books are stored as an array of structs, so each update gathers the price and
+// quantity columns into contiguous scratch arrays, runs branch-free passes over
+// them (which the compiler can vectorize), and scatters the results back.
+typedef struct {
+    float *price;
+    int *quantity;
+    float *selected; // 1.0 where the filter matches, else 0.0
+} BookColumns;
+
+static int gatherColumns(const Book *books, int numBooks, BookColumns *columns) {
+    size_t count = numBooks > 0 ? (size_t)numBooks : 1;
+    columns->price = memAlloc(MEM_BOOKS, count * sizeof(float));
+    columns->quantity = memAlloc(MEM_BOOKS, count * sizeof(int));
+    columns->selected = memAlloc(MEM_BOOKS, count * sizeof(float));
+    if (!columns->price || !columns->quantity || !columns->selected) {
+        perror("Memory allocation failed");
+        memFree(columns->price);
+        memFree(columns->quantity);
+        memFree(columns->selected);
+        return -1;
+    }
+    for (int i = 0; i < numBooks; i++) {
+        columns->price[i] = books[i].price;
+        columns->quantity[i] = books[i].quantity;
+    }
+    return 0;
+}
+
+static void freeColumns(BookColumns *columns) {
+    memFree(columns->price);
+    memFree(columns->quantity);
+    memFree(columns->selected);
+}
+
+// Build the selection mask; returns the number of matching books
+static int selectBooks(const Book *books, int numBooks, const BookFilter *filter, BookColumns *columns) {
+    float minPrice = filter->minPrice > 0 ? filter->minPrice : -INFINITY;
+    float maxPrice = filter->maxPrice > 0 ? filter->maxPrice : INFINITY;
+    int maxQuantity = filter->maxQuantity >= 0 ? filter->maxQuantity : INT_MAX;
+    const float *restrict price = columns->price;
+    const int *restrict quantity = columns->quantity;
+    float *restrict selected = columns->selected;
+
+    // Numeric predicates: one branch-free pass over the columns
+    for (int i = 0; i < numBooks; i++) {
+        selected[i] = (float)((price[i] >= minPrice) & (price[i] < maxPrice) & (quantity[i] < maxQuantity));
+    }
+
+    // String predicate only where a numeric predicate already matched
+    if (filter->author) {
+        for (int i = 0; i < numBooks; i++) {
+            if (selected[i] != 0.0f && strcasecmp(books[i].author, filter->author) != 0) {
+                selected[i] = 0.0f;
+            }
+        }
+    }
+
+    float matches = 0.0f;
+    for (int i = 0; i < numBooks; i++) {
+        matches += selected[i];
+    }
+    return (int)matches;
+}
+
+// Function to reprice every matching book by percent (e.g. 5 for +5%, -20 for -20%)
+int bulkAdjustPrice(Book *books, int numBooks, const BookFilter *filter, float percent) {
+    OP_LATENCY_SCOPE(OP_BULK_ADJUST);
+    if (percent <= -100.0f) {
+        fprintf(stderr, "Error: A price adjustment must keep prices positive.\n");
+        return 0;
+    }
+
+    PROFILED_LOCK(&bookMutex);
+
+    BookColumns columns;
+    if (gatherColumns(books, numBooks, &columns) != 0) {
+        PROFILED_UNLOCK(&bookMutex);
+        return 0;
+    }
+
+    int matches = selectBooks(books, numBooks, filter, &columns);
+    if (matches > 0) {
+        const float delta = percent / 100.0f;
+        float *restrict price = columns.price;
+        const float *restrict selected = columns.selected;
+        float nonPositive = 0.0f; // Selected prices that rounding would take to zero or below
+        for (int i = 0; i < numBooks; i++) {
+            // Round to whole cents; a select (not a branch) keeps unmatched prices exactly as they were
+            float adjusted = floorf(price[i] * (1.0f + delta) * 100.0f + 0.5f) / 100.0f;
+            nonPositive += selected[i] * (float)(adjusted <= 0.0f);
+            price[i] = selected[i] != 0.0f ? adjusted : price[i];
+        }
+        if (nonPositive > 0.0f) {
+            // All or nothing, like the other bulk paths: a price must stay positive
+            fprintf(stderr, "Error: The adjustment would round %d price(s) to zero; no books were changed.\n",
+                    (int)nonPositive);
+            matches = 0;
+        } else {
+            for (int i = 0; i < numBooks; i++) {
+                if (selected[i] != 0.0f) {
+                    books[i].price = price[i];
+                }
+            }
+            rebuildCatalogIndex(books, numBooks); // Cheaper than re-keying a large selection one by one
+            saveBooks(books, numBooks);
+        }
+    }
+
+    freeColumns(&columns);
+    PROFILED_UNLOCK(&bookMutex);
+    return matches;
+}
+
+// Function to restock (or write down) every matching book by delta, never below zero
+int bulkAdjustQuantity(Book *books, int numBooks, const BookFilter *filter, int delta) {
+    OP_LATENCY_SCOPE(OP_BULK_ADJUST);
+    PROFILED_LOCK(&bookMutex);
+
+    BookColumns columns;
+    if (gatherColumns(books, numBooks, &columns) != 0) {
+        PROFILED_UNLOCK(&bookMutex);
+        return 0;
+    }
+
+    int matches = selectBooks(books, numBooks, filter, &columns);
+    if (matches > 0) {
+        int *restrict quantity = columns.quantity;
+        const float *restrict selected = columns.selected;
+        for (int i = 0; i < numBooks; i++) {
+            // 64-bit sum so a large delta clamps instead of overflowing
+            long long updated = (long long)quantity[i] + (long long)selected[i] * delta;
+            updated = updated > 0 ? updated : 0;
+            quantity[i] = (int)(updated < INT_MAX ? updated : INT_MAX);
+        }
+        for (int i = 0; i < numBooks; i++) {
+            if (selected[i] != 0.0f) {
+                books[i].quantity = quantity[i];
+            }
+        }
+        rebuildCatalogIndex(books, numBooks);
+        saveBooks(books, numBooks);
+    }
+
+    freeColumns(&columns);
+    PROFILED_UNLOCK(&bookMutex);
+    return matches;
+}
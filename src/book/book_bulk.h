@@ -0,0 +1,19 @@
+#ifndef BOOK_BULK_H
+#define BOOK_BULK_H
+
+#include "book.h"
+
+// Predicate selecting the books a bulk update applies to (all bounds optional)
+typedef struct {
+    const char *author; // Case-insensitive exact author match; NULL for any author
+    float minPrice;     // Inclusive; <= 0 for no lower bound
+    float maxPrice;     // Exclusive; <= 0 for no upper bound
+    int maxQuantity;    // Exclusive; < 0 for no bound
+} BookFilter;
+
+// Function prototypes (declarations)
+// Both return the number of books changed and save the catalog once per call.
+int bulkAdjustPrice(Book *books, int numBooks, const BookFilter *filter, float percent);
+int bulkAdjustQuantity(Book *books, int numBooks, const BookFilter *filter, int delta);
+
+#endif // BOOK_BULK_H
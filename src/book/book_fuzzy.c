@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "book_fuzzy.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/trace.h"
+#include "../metrics/mem_account.h"
+
+// Compiled query: for each byte, the query positions it matches (both cases set)
+typedef struct {
+    uint64_t positions[256];
+    int length;
+    int maxErrors;
+} FuzzyPattern;
+
+// Work assigned to one search worker
+typedef struct {
+    const FuzzyPattern *pattern;
+    const Book *books;
+    int begin;
+    int end;
+    TitleMatch *out; // This worker's own region of the shared buffer, starting at begin
+    int count;
+} FuzzyTask;
+
+static void compilePattern(FuzzyPattern *pattern, const char *query, int maxErrors) {
+    memset(pattern->positions, 0, sizeof(pattern->positions));
+    int length = 0;
+    for (; query[length] != '\0' && length < FUZZY_MAX_PATTERN; length++) {
+        unsigned char c = (unsigned char)query[length];
+        pattern->positions[tolower(c)] |= 1ull << length;
+        pattern->positions[toupper(c)] |= 1ull << length;
+    }
+    pattern->length = length;
+
+    if (maxErrors < 0) {
+        maxErrors = length / 4 < FUZZY_MAX_ERRORS ? length / 4 : FUZZY_MAX_ERRORS;
+    }
+    pattern->maxErrors = maxErrors < length ? maxErrors : length - 1; // At least one character must match
+}
+
+// Best edit distance of the query against any substring of title (Myers 1999,
+// with the text start left free), or -1 if above the error budget
+static int titleDistance(const FuzzyPattern *pattern, const char *title) {
+    uint64_t positive = ~0ull, negative = 0;
+    const uint64_t last = 1ull << (pattern->length - 1);
+    int score = pattern->length, best = pattern->length;
+
+    for (const unsigned char *c = (const unsigned char *)title; *c != '\0'; c++) {
+        uint64_t equal = pattern->positions[*c];
+        uint64_t vertical = equal | negative;
+        uint64_t horizontal = (((equal & positive) + positive) ^ positive) | equal;
+        uint64_t up = negative | ~(horizontal | positive);
+        uint64_t down = positive & horizontal;
+        if (up & last) {
+            score++;
+        } else if (down & last) {
+            score--;
+        }
+        up <<= 1;
+        down <<= 1;
+        positive = down | ~(vertical | up);
+        negative = up & vertical;
+        if (score < best) {
+            best = score;
+            if (best == 0) {
+                break; // Exact occurrence; nothing can beat it
+            }
+        }
+    }
+    return best <= pattern->maxErrors ? best : -1;
+}
+
+static void *fuzzyWorker(void *arg) {
+    FuzzyTask *task = (FuzzyTask *)arg;
+    task->count = 0;
+    for (int i = task->begin; i < task->end; i++) {
+        int distance = titleDistance(task->pattern, task->books[i].title);
+        if (distance >= 0) {
+            task->out[task->count].ISBN = task->books[i].ISBN;
+            task->out[task->count].distance = distance;
+            task->count++;
+        }
+    }
+    return NULL;
+}
+
+static int chooseThreadCount(int numBooks, int numThreads) {
+    if (numThreads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (numThreads > MAX_FUZZY_THREADS) {
+        numThreads = MAX_FUZZY_THREADS;
+    }
+    int useful = numBooks / MIN_BOOKS_PER_FUZZY_THREAD;
+    if (numThreads > useful) {
+        numThreads = useful;
+    }
+    return numThreads > 0 ? numThreads : 1;
+}
+
+static int compareTitleMatch(const void *a, const void *b) {
+    const TitleMatch *x = a, *y = b;
+    if (x->distance != y->distance) {
+        return x->distance - y->distance;
+    }
+    return x->ISBN < y->ISBN ? -1 : (x->ISBN > y->ISBN);
+}
+
+// Function to search titles allowing typos, closest matches first
+int searchBooksByTitleFuzzy(const Book *books, int numBooks, const char *query, int maxErrors, int numThreads,
+                            TitleMatch *matches, int maxResults) {
+    TRACE_SPAN("searchBooksByTitleFuzzy");
+    FuzzyPattern pattern;
+    compilePattern(&pattern, query, maxErrors);
+    if (pattern.length == 0 || numBooks <= 0) {
+        return 0;
+    }
+
+    TitleMatch *found = memAlloc(MEM_REPORTS, (size_t)numBooks * sizeof(TitleMatch));
+    if (!found) {
+        perror("Memory allocation failed");
+        return 0;
+    }
+
+    pthread_t threads[MAX_FUZZY_THREADS];
+    FuzzyTask tasks[MAX_FUZZY_THREADS];
+    int started[MAX_FUZZY_THREADS] = {0};
+
+    PROFILED_LOCK(&bookMutex);
+    numThreads = chooseThreadCount(numBooks, numThreads);
+    // Contiguous partitions; each worker compacts its hits at the front of its own range
+    for (int t = 0; t < numThreads; t++) {
+        tasks[t].pattern = &pattern;
+        tasks[t].books = books;
+        tasks[t].begin = (int)((long long)numBooks * t / numThreads);
+        tasks[t].end = (int)((long long)numBooks * (t + 1) / numThreads);
+        tasks[t].out = &found[tasks[t].begin];
+    }
+    for (int t = 1; t < numThreads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, fuzzyWorker, &tasks[t]) == 0;
+        if (!started[t]) {
+            fuzzyWorker(&tasks[t]); // Fall back to doing this partition inline
+        }
+    }
+    fuzzyWorker(&tasks[0]); // The calling thread takes the first partition
+    int count = tasks[0].count;
+    for (int t = 1; t < numThreads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        memmove(&found[count], tasks[t].out, tasks[t].count * sizeof(TitleMatch));
+        count += tasks[t].count;
+    }
+    PROFILED_UNLOCK(&bookMutex);
+
+    qsort(found, count, sizeof(TitleMatch), compareTitleMatch);
+    if (count > maxResults) {
+        count = maxResults;
+    }
+    memcpy(matches, found, count * sizeof(TitleMatch));
+    memFree(found);
+    return count;
+}
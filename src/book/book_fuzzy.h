@@ -0,0 +1,27 @@
+#ifndef BOOK_FUZZY_H
+#define BOOK_FUZZY_H
+
+#include "book.h"
+
+#define FUZZY_MAX_PATTERN 64 // Query characters matched; longer queries are cut (one machine word of state)
+#define FUZZY_MAX_ERRORS 3   // Budget chosen when the caller passes a negative maxErrors
+#define MAX_FUZZY_THREADS 16
+#define MIN_BOOKS_PER_FUZZY_THREAD 2048 // Below this a partition is not worth a thread
+
+typedef struct {
+    int ISBN;
+    int distance; // Fewest edits turning the query into some substring of the title
+} TitleMatch;
+
+// Function prototypes (declarations)
+// Typo-tolerant, case-insensitive title search: finds titles containing the
+// query with at most maxErrors insertions, deletions or substitutions (negative
+// means one per four query characters, up to FUZZY_MAX_ERRORS). Each title
+// costs one pass of Myers' bit-parallel algorithm, so a query is linear in
+// the catalog's title text. Uses up to numThreads workers (<= 0 means one per
+// online CPU) on catalogs large enough to split. Fills matches ranked by
+// distance, then ISBN, and returns how many; takes bookMutex itself.
+int searchBooksByTitleFuzzy(const Book *books, int numBooks, const char *query, int maxErrors, int numThreads,
+                            TitleMatch *matches, int maxResults);
+
+#endif // BOOK_FUZZY_H
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "book_import.h"
+#include "book_index.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/mem_account.h"
+
+// A feed row plus its position, so sorting can keep the last row per ISBN
+typedef struct {
+    Book book;
+    long sequence;
+} FeedRow;
+
+static int compareFeedRows(const void *a, const void *b) {
+    const FeedRow *x = a, *y = b;
+    if (x->book.ISBN != y->book.ISBN) {
+        return (x->book.ISBN > y->book.ISBN) - (x->book.ISBN < y->book.ISBN);
+    }
+    return (x->sequence > y->sequence) - (x->sequence < y->sequence);
+}
+
+static int compareBooksByISBN(const void *a, const void *b) {
+    const Book *x = a, *y = b;
+    return (x->ISBN > y->ISBN) - (x->ISBN < y->ISBN);
+}
+
+// A header names its columns: its first field is not a number, as an ISBN would be
+static int looksLikeHeader(const char *line) {
+    char *end;
+    strtol(line, &end, 10);
+    end += strspn(end, " \t");
+    return end == line || (*end != ',' && *end != '\r' && *end != '\n' && *end != '\0');
+}
+
+// Read the whole feed into a growable array; returns the row count or -1
+static long readFeed(FILE *file, FeedRow **rowsOut, ImportResult *result) {
+    long capacity = 1024, count = 0;
+    FeedRow *rows = memAlloc(MEM_BOOKS, capacity * sizeof(FeedRow));
+    if (!rows) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+
+    char line[256];
+    int firstLine = 1;
+    while (fgets(line, sizeof(line), file)) {
+        if (strspn(line, " \t\r\n") == strlen(line)) {
+            continue; // Blank line
+        }
+        Book book;
+        int parsed = sscanf(line, "%d,%99[^,],%49[^,],%f,%d", &book.ISBN, book.title, book.author,
+                            &book.price, &book.quantity) == 5;
+        if (!parsed && firstLine && looksLikeHeader(line)) {
+            firstLine = 0;
+            continue; // Header row
+        }
+        firstLine = 0;
+        result->rowsRead++;
+        if (!parsed) {
+            result->rejected++;
+            continue;
+        }
+        if (book.ISBN <= 0 || book.price <= 0 || book.quantity < 0) {
+            result->rejected++;
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            FeedRow *grown = memRealloc(rows, capacity * sizeof(FeedRow));
+            if (!grown) {
+                perror("Memory allocation failed");
+                memFree(rows);
+                return -1;
+            }
+            rows = grown;
+        }
+        rows[count].book = book;
+        rows[count].sequence = count;
+        count++;
+    }
+
+    *rowsOut = rows;
+    return count;
+}
+
+// Function to bulk upsert a publisher feed in O((n + m) log(n + m))
+int importCatalog(const char *path, Book *books, int *numBooks, ImportResult *result) {
+    OP_LATENCY_SCOPE(OP_IMPORT_CATALOG);
+    memset(result, 0, sizeof(*result));
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("Error opening catalog feed for reading");
+        return -1;
+    }
+    FeedRow *feed = NULL;
+    long feedCount = readFeed(file, &feed, result);
+    fclose(file);
+    if (feedCount < 0) {
+        return -1;
+    }
+
+    // Sort the feed by ISBN (ties in file order) so the last row per ISBN wins
+    qsort(feed, feedCount, sizeof(FeedRow), compareFeedRows);
+
+    PROFILED_LOCK(&bookMutex);
+
+    Book *merged = memAlloc(MEM_BOOKS, MAX_BOOKS * sizeof(Book));
+    if (!merged) {
+        perror("Memory allocation failed");
+        PROFILED_UNLOCK(&bookMutex);
+        memFree(feed);
+        return -1;
+    }
+
+    qsort(books, *numBooks, sizeof(Book), compareBooksByISBN);
+
+    // Sorted merge of catalog and feed
+    int out = 0, existing = 0;
+    long next = 0;
+    while (existing < *numBooks || next < feedCount) {
+        if (next < feedCount && next + 1 < feedCount && feed[next + 1].book.ISBN == feed[next].book.ISBN) {
+            result->duplicates++; // Superseded by a later row
+            next++;
+            continue;
+        }
+
+        if (next >= feedCount || (existing < *numBooks && books[existing].ISBN < feed[next].book.ISBN)) {
+            merged[out++] = books[existing++];
+        } else if (existing < *numBooks && books[existing].ISBN == feed[next].book.ISBN) {
+            merged[out] = books[existing++];
+            merged[out].price = feed[next].book.price;
+            merged[out].quantity = feed[next].book.quantity;
+            out++;
+            next++;
+            result->updated++;
+        } else if (out + (*numBooks - existing) < MAX_BOOKS) { // Keep room for the remaining catalog
+            merged[out++] = feed[next++].book;
+            result->inserted++;
+        } else {
+            next++;
+            result->rejected++; // Catalog full
+        }
+    }
+
+    memcpy(books, merged, out * sizeof(Book));
+    *numBooks = out;
+    rebuildCatalogIndex(books, *numBooks);
+    saveBooks(books, *numBooks);
+
+    PROFILED_UNLOCK(&bookMutex);
+
+    memFree(merged);
+    memFree(feed);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef BOOK_IMPORT_H
+#define BOOK_IMPORT_H
+
+#include "book.h"
+
+// Outcome of a catalog feed import
+typedef struct {
+    long rowsRead;
+    long inserted;   // New titles added
+    long updated;    // Existing titles whose price and quantity were replaced
+    long duplicates; // Feed rows superseded by a later row for the same ISBN
+    long rejected;   // Malformed rows, or new titles that did not fit in the catalog
+} ImportResult;
+
+// Function prototypes (declarations)
+// Upserts a publisher feed ("ISBN,title,author,price,quantity" per line, optional
+// header) into the catalog: the feed is sorted and deduplicated by ISBN, merged
+// against the ISBN-sorted catalog, and saved once. Leaves the catalog sorted by ISBN.
+int importCatalog(const char *path, Book *books, int *numBooks, ImportResult *result);
+
+#endif // BOOK_IMPORT_H
@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include "book_index.h"
+#include "../metrics/lock_profile.h"
+
+CatalogIndex catalogIndex;
+
+// First slot whose (price, ISBN) is not below the given pair
+static int priceLowerBound(float price, int ISBN) {
+    int low = 0, high = catalogIndex.priceCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const PriceEntry *entry = &catalogIndex.byPrice[mid];
+        if (entry->price < price || (entry->price == price && entry->ISBN < ISBN)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static int quantityLowerBound(int quantity, int ISBN) {
+    int low = 0, high = catalogIndex.quantityCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const QuantityEntry *entry = &catalogIndex.byQuantity[mid];
+        if (entry->quantity < quantity || (entry->quantity == quantity && entry->ISBN < ISBN)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void priceInsert(float price, int ISBN) {
+    if (catalogIndex.priceCount >= MAX_BOOKS) {
+        fprintf(stderr, "Error: Price index full, ISBN %d not indexed.\n", ISBN);
+        return;
+    }
+    int pos = priceLowerBound(price, ISBN);
+    memmove(&catalogIndex.byPrice[pos + 1], &catalogIndex.byPrice[pos],
+            (catalogIndex.priceCount - pos) * sizeof(PriceEntry));
+    catalogIndex.byPrice[pos].price = price;
+    catalogIndex.byPrice[pos].ISBN = ISBN;
+    catalogIndex.priceCount++;
+}
+
+static void quantityInsert(int quantity, int ISBN) {
+    if (catalogIndex.quantityCount >= MAX_BOOKS) {
+        fprintf(stderr, "Error: Quantity index full, ISBN %d not indexed.\n", ISBN);
+        return;
+    }
+    int pos = quantityLowerBound(quantity, ISBN);
+    memmove(&catalogIndex.byQuantity[pos + 1], &catalogIndex.byQuantity[pos],
+            (catalogIndex.quantityCount - pos) * sizeof(QuantityEntry));
+    catalogIndex.byQuantity[pos].quantity = quantity;
+    catalogIndex.byQuantity[pos].ISBN = ISBN;
+    catalogIndex.quantityCount++;
+}
+
+// Remove by exact key; if the caller's old value was stale, fall back to a scan by ISBN
+static void priceRemove(float price, int ISBN) {
+    int pos = priceLowerBound(price, ISBN);
+    if (pos >= catalogIndex.priceCount || catalogIndex.byPrice[pos].ISBN != ISBN) {
+        for (pos = 0; pos < catalogIndex.priceCount && catalogIndex.byPrice[pos].ISBN != ISBN; pos++) {
+        }
+        if (pos == catalogIndex.priceCount) {
+            return;
+        }
+    }
+    memmove(&catalogIndex.byPrice[pos], &catalogIndex.byPrice[pos + 1],
+            (catalogIndex.priceCount - pos - 1) * sizeof(PriceEntry));
+    catalogIndex.priceCount--;
+}
+
+static void quantityRemove(int quantity, int ISBN) {
+    int pos = quantityLowerBound(quantity, ISBN);
+    if (pos >= catalogIndex.quantityCount || catalogIndex.byQuantity[pos].ISBN != ISBN) {
+        for (pos = 0; pos < catalogIndex.quantityCount && catalogIndex.byQuantity[pos].ISBN != ISBN; pos++) {
+        }
+        if (pos == catalogIndex.quantityCount) {
+            return;
+        }
+    }
+    memmove(&catalogIndex.byQuantity[pos], &catalogIndex.byQuantity[pos + 1],
+            (catalogIndex.quantityCount - pos - 1) * sizeof(QuantityEntry));
+    catalogIndex.quantityCount--;
+}
+
+// Lowercase copy of text, truncated to fit the key
+static void foldAuthorKey(char *key, const char *text) {
+    int i = 0;
+    for (; text[i] != '\0' && i < MAX_AUTHOR_LENGTH - 1; i++) {
+        key[i] = (char)tolower((unsigned char)text[i]);
+    }
+    key[i] = '\0';
+}
+
+// Offsets of the name words keyed for an author; returns how many
+static int authorKeyStarts(const char *author, int *starts) {
+    int count = 0;
+    for (int i = 0; author[i] != '\0' && count < AUTHOR_KEYS_PER_BOOK; i++) {
+        if (isalnum((unsigned char)author[i]) && (i == 0 || !isalnum((unsigned char)author[i - 1]))) {
+            starts[count++] = i;
+        }
+    }
+    return count;
+}
+
+static int authorLowerBound(const char *key, int ISBN) {
+    int low = 0, high = catalogIndex.authorCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const AuthorEntry *entry = &catalogIndex.byAuthor[mid];
+        int order = strcmp(entry->key, key);
+        if (order < 0 || (order == 0 && entry->ISBN < ISBN)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void authorInsert(const char *author, int ISBN) {
+    int starts[AUTHOR_KEYS_PER_BOOK];
+    int keys = authorKeyStarts(author, starts);
+    for (int k = 0; k < keys; k++) {
+        if (catalogIndex.authorCount >= MAX_BOOKS * AUTHOR_KEYS_PER_BOOK) {
+            fprintf(stderr, "Error: Author index full, ISBN %d not fully indexed.\n", ISBN);
+            return;
+        }
+        char key[MAX_AUTHOR_LENGTH];
+        foldAuthorKey(key, author + starts[k]);
+        int pos = authorLowerBound(key, ISBN);
+        memmove(&catalogIndex.byAuthor[pos + 1], &catalogIndex.byAuthor[pos],
+                (catalogIndex.authorCount - pos) * sizeof(AuthorEntry));
+        strcpy(catalogIndex.byAuthor[pos].key, key);
+        catalogIndex.byAuthor[pos].ISBN = ISBN;
+        catalogIndex.authorCount++;
+    }
+}
+
+// Drops every key of the book; as with the other indexes, a stale author falls back to a scan
+static void authorRemove(const char *author, int ISBN) {
+    int starts[AUTHOR_KEYS_PER_BOOK];
+    int keys = authorKeyStarts(author, starts);
+    int removed = 0;
+    for (int k = 0; k < keys; k++) {
+        char key[MAX_AUTHOR_LENGTH];
+        foldAuthorKey(key, author + starts[k]);
+        int pos = authorLowerBound(key, ISBN);
+        if (pos < catalogIndex.authorCount && catalogIndex.byAuthor[pos].ISBN == ISBN &&
+            strcmp(catalogIndex.byAuthor[pos].key, key) == 0) {
+            memmove(&catalogIndex.byAuthor[pos], &catalogIndex.byAuthor[pos + 1],
+                    (catalogIndex.authorCount - pos - 1) * sizeof(AuthorEntry));
+            catalogIndex.authorCount--;
+            removed++;
+        }
+    }
+    if (removed == keys) {
+        return;
+    }
+    int out = 0;
+    for (int i = 0; i < catalogIndex.authorCount; i++) {
+        if (catalogIndex.byAuthor[i].ISBN != ISBN) {
+            catalogIndex.byAuthor[out++] = catalogIndex.byAuthor[i];
+        }
+    }
+    catalogIndex.authorCount = out;
+}
+
+void rebuildCatalogIndex(const Book *books, int numBooks) {
+    catalogIndex.priceCount = 0;
+    catalogIndex.quantityCount = 0;
+    catalogIndex.authorCount = 0;
+    for (int i = 0; i < numBooks; i++) {
+        indexAddBook(&books[i]);
+    }
+}
+
+void indexAddBook(const Book *book) {
+    priceInsert(book->price, book->ISBN);
+    quantityInsert(book->quantity, book->ISBN);
+    authorInsert(book->author, book->ISBN);
+}
+
+void indexRemoveBook(const Book *book) {
+    priceRemove(book->price, book->ISBN);
+    quantityRemove(book->quantity, book->ISBN);
+    authorRemove(book->author, book->ISBN);
+}
+
+// Re-key only the columns that changed (a sale touches just the quantity index)
+void indexUpdateBook(const Book *before, const Book *after) {
+    if (before->price != after->price || before->ISBN != after->ISBN) {
+        priceRemove(before->price, before->ISBN);
+        priceInsert(after->price, after->ISBN);
+    }
+    if (before->quantity != after->quantity || before->ISBN != after->ISBN) {
+        quantityRemove(before->quantity, before->ISBN);
+        quantityInsert(after->quantity, after->ISBN);
+    }
+    if (strcmp(before->author, after->author) != 0 || before->ISBN != after->ISBN) {
+        authorRemove(before->author, before->ISBN);
+        authorInsert(after->author, after->ISBN);
+    }
+}
+
+int findBooksByPriceRange(float minPrice, float maxPrice, int *ISBNs, int maxResults) {
+    int count = 0;
+    PROFILED_LOCK(&bookMutex);
+    for (int i = priceLowerBound(minPrice, INT_MIN);
+         i < catalogIndex.priceCount && catalogIndex.byPrice[i].price <= maxPrice && count < maxResults; i++) {
+        ISBNs[count++] = catalogIndex.byPrice[i].ISBN;
+    }
+    PROFILED_UNLOCK(&bookMutex);
+    return count;
+}
+
+int findBooksByQuantityRange(int minQuantity, int maxQuantity, int *ISBNs, int maxResults) {
+    int count = 0;
+    PROFILED_LOCK(&bookMutex);
+    for (int i = quantityLowerBound(minQuantity, INT_MIN);
+         i < catalogIndex.quantityCount && catalogIndex.byQuantity[i].quantity <= maxQuantity && count < maxResults;
+         i++) {
+        ISBNs[count++] = catalogIndex.byQuantity[i].ISBN;
+    }
+    PROFILED_UNLOCK(&bookMutex);
+    return count;
+}
+
+// Function to list titles due for reorder straight off the front of the quantity index
+int findLowStockBooks(int threshold, int *ISBNs, int maxResults) {
+    if (threshold <= INT_MIN + 1) {
+        return 0;
+    }
+    return findBooksByQuantityRange(INT_MIN, threshold - 1, ISBNs, maxResults);
+}
+
+// Function to find books whose author name, or any word of it, starts with prefix
+int findBooksByAuthorPrefix(const char *prefix, int *ISBNs, int maxResults) {
+    char key[MAX_AUTHOR_LENGTH];
+    foldAuthorKey(key, prefix);
+    size_t length = strlen(key);
+    if (length == 0) {
+        return 0;
+    }
+
+    int count = 0;
+    PROFILED_LOCK(&bookMutex);
+    for (int i = authorLowerBound(key, INT_MIN);
+         i < catalogIndex.authorCount && strncmp(catalogIndex.byAuthor[i].key, key, length) == 0 && count < maxResults;
+         i++) {
+        int ISBN = catalogIndex.byAuthor[i].ISBN;
+        int seen = 0;
+        for (int j = 0; j < count && !seen; j++) {
+            seen = ISBNs[j] == ISBN; // Same book matched through another name word
+        }
+        if (!seen) {
+            ISBNs[count++] = ISBN;
+        }
+    }
+    PROFILED_UNLOCK(&bookMutex);
+    return count;
+}
@@ -0,0 +1,54 @@
+#ifndef BOOK_INDEX_H
+#define BOOK_INDEX_H
+
+#include "book.h"
+
+#define LOW_STOCK_THRESHOLD 5 // Reorder alert when quantity drops below this
+#define AUTHOR_KEYS_PER_BOOK 4 // Name words indexed per author ("J. R. R. Tolkien" keys the first four)
+
+// Ordered secondary indexes over the catalog: entries sorted by (key, ISBN),
+// so a range query is a binary search plus a walk over the matches.
+typedef struct {
+    float price;
+    int ISBN;
+} PriceEntry;
+
+typedef struct {
+    int quantity;
+    int ISBN;
+} QuantityEntry;
+
+// Case-folded author text from the start of one name word to the end, so a
+// prefix can match the whole name ("j.r.r. tol") or any later word ("tolk")
+typedef struct {
+    char key[MAX_AUTHOR_LENGTH];
+    int ISBN;
+} AuthorEntry;
+
+// Guarded by bookMutex, like the book array it mirrors
+typedef struct {
+    PriceEntry byPrice[MAX_BOOKS];
+    int priceCount;
+    QuantityEntry byQuantity[MAX_BOOKS];
+    int quantityCount;
+    AuthorEntry byAuthor[MAX_BOOKS * AUTHOR_KEYS_PER_BOOK];
+    int authorCount;
+} CatalogIndex;
+
+extern CatalogIndex catalogIndex;
+
+// Function prototypes (declarations)
+// Maintenance; the caller holds bookMutex
+void rebuildCatalogIndex(const Book *books, int numBooks);
+void indexAddBook(const Book *book);
+void indexRemoveBook(const Book *book);
+void indexUpdateBook(const Book *before, const Book *after);
+
+// Range queries (inclusive bounds) fill ISBNs in key order and return how
+// many were written, at most maxResults. They take bookMutex themselves.
+int findBooksByPriceRange(float minPrice, float maxPrice, int *ISBNs, int maxResults);
+int findBooksByQuantityRange(int minQuantity, int maxQuantity, int *ISBNs, int maxResults);
+int findLowStockBooks(int threshold, int *ISBNs, int maxResults); // quantity < threshold, lowest first
+int findBooksByAuthorPrefix(const char *prefix, int *ISBNs, int maxResults); // Case-insensitive, by author
+
+#endif // BOOK_INDEX_H
@@ -4,29 +4,28 @@
 #include <pthread.h>
 #include <ctype.h> // for isdigit()
 #include "customer.h"
+#include "customer_index.h"
 #include "../book/book.h"
 #include "../sales/sales.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../render/render.h"
+#include "../listing/listing.h"
+#include "../metrics/mem_account.h"
 
 #define CUSTOMERS_DATA_FILE "data/customers.csv"
-#define MAX_CUSTOMERS 100
-#define MAX_SALES 100
-#define MAX_NAME_LENGTH 50
-#define MAX_PHONE_LENGTH 20
-#define MAX_BOOKS 100 // Define MAX_BOOKS here
-
-Book books[MAX_BOOKS];       // Array to store book data
-int numBooks = 0;            // Number of books currently in the system
+
 Customer customers[MAX_CUSTOMERS]; // Array to store customer data
 int numCustomers = 0;        // Number of customers currently in the system
-Sale sales[MAX_SALES];       // Array to store sales data
-int numSales = 0;            // Number of sales made
 
 // Mutex for Thread Synchronization
 pthread_mutex_t dataMutex = PTHREAD_MUTEX_INITIALIZER; // Initialize the mutex
 
+static void writeCustomersFile(const Customer *customers, int numCustomers);
+
 // Thread function for adding a customer
 void *addCustomerThread(void *arg) {
-    pthread_mutex_lock(&dataMutex); // Lock the mutex to ensure exclusive access to shared data.
+    PROFILED_LOCK(&dataMutex); // Lock the mutex to ensure exclusive access to shared data.
 
     Customer *newCustomer = (Customer *)arg;
 
@@ -53,7 +52,7 @@ void *addCustomerThread(void *arg) {
     if (scanf("%49[a-zA-Z ]", newCustomer->name) != 1) {
         printf("Invalid name. Please use only letters and spaces.\n");
         while (getchar() != '\n');
-        pthread_mutex_unlock(&dataMutex);
+        PROFILED_UNLOCK(&dataMutex);
         pthread_exit(NULL);
     }
 
@@ -62,39 +61,42 @@ void *addCustomerThread(void *arg) {
     if (scanf("%19s", newCustomer->phone) != 1) {
         printf("Invalid phone number. Please use only digits.\n");
         while (getchar() != '\n');
-        pthread_mutex_unlock(&dataMutex);
+        PROFILED_UNLOCK(&dataMutex);
         pthread_exit(NULL);
     }
     for (int i = 0; newCustomer->phone[i]; i++) {
         if (!isdigit(newCustomer->phone[i])) {
             printf("Invalid phone number. Please use only digits.\n");
-            pthread_mutex_unlock(&dataMutex);
+            PROFILED_UNLOCK(&dataMutex);
             pthread_exit(NULL);
         }
     }
 
     if (numCustomers < MAX_CUSTOMERS) {
         customers[numCustomers] = *newCustomer;
+        indexAddCustomer(newCustomer);
         numCustomers++;
-        saveCustomers(customers, numCustomers);
+        writeCustomersFile(customers, numCustomers); // Already holding dataMutex
         printf("Customer added successfully in a separate thread!\n");
     } else {
         printf("Error: Maximum number of customers reached.\n");
     }
 
-    pthread_mutex_unlock(&dataMutex); // Release the mutex after finishing with the shared data.
+    PROFILED_UNLOCK(&dataMutex); // Release the mutex after finishing with the shared data.
     pthread_exit(NULL); // Exit the thread.
 }
 
 // Function to load customer data from file (with error handling)
 void loadCustomers(Customer *customers, int *numCustomers) {
-    pthread_mutex_lock(&dataMutex);
+    OP_LATENCY_SCOPE(OP_LOAD_CUSTOMERS);
+    PROFILED_LOCK(&dataMutex);
 
     FILE *file = fopen(CUSTOMERS_DATA_FILE, "r");
     if (!file) {
         perror("Error opening customers file for reading");
         *numCustomers = 0;
-        pthread_mutex_unlock(&dataMutex);
+        rebuildCustomerIndex(customers, 0);
+        PROFILED_UNLOCK(&dataMutex);
         return;
     }
 
@@ -112,17 +114,16 @@ void loadCustomers(Customer *customers, int *numCustomers) {
     }
 
     fclose(file);
-    pthread_mutex_unlock(&dataMutex);
+    rebuildCustomerIndex(customers, *numCustomers);
+    PROFILED_UNLOCK(&dataMutex);
 }
 
-// Function to save customer data to file (with error handling)
-void saveCustomers(const Customer *customers, int numCustomers) {
-    pthread_mutex_lock(&dataMutex);
-
+// Writes the customer file; the caller holds dataMutex
+static void writeCustomersFile(const Customer *customers, int numCustomers) {
+    OP_LATENCY_SCOPE(OP_SAVE_CUSTOMERS);
     FILE *file = fopen(CUSTOMERS_DATA_FILE, "w");
     if (!file) {
         perror("Error opening customers file for writing");
-        pthread_mutex_unlock(&dataMutex);
         return;
     }
 
@@ -135,7 +136,13 @@ void saveCustomers(const Customer *customers, int numCustomers) {
     }
 
     fclose(file);
-    pthread_mutex_unlock(&dataMutex);
+}
+
+// Function to save customer data to file (with error handling)
+void saveCustomers(const Customer *customers, int numCustomers) {
+    PROFILED_LOCK(&dataMutex);
+    writeCustomersFile(customers, numCustomers);
+    PROFILED_UNLOCK(&dataMutex);
 }
 
 // Function to add a customer (with input validation)
@@ -199,14 +206,53 @@ void addCustomer(Customer *customers, int *numCustomers) {
     } while (1);
 
     // Add customer to the array and save to file
-    customers[*numCustomers] = newCustomer;
+    if (insertCustomer(customers, numCustomers, &newCustomer) == 0) {
+        printf("Customer added successfully!\n");
+    }
+}
+
+// Non-interactive add: validates, appends and saves; returns 0 on success, -1 on error
+int insertCustomer(Customer *customers, int *numCustomers, const Customer *newCustomer) {
+    OP_LATENCY_SCOPE(OP_INSERT_CUSTOMER);
+    if (newCustomer->customerID <= 0 || newCustomer->name[0] == '\0') {
+        fprintf(stderr, "Error: Invalid customer details.\n");
+        return -1;
+    }
+    for (int i = 0; newCustomer->phone[i]; i++) {
+        if (!isdigit((unsigned char)newCustomer->phone[i])) {
+            fprintf(stderr, "Error: Invalid phone number. Please use only digits.\n");
+            return -1;
+        }
+    }
+
+    // Check, append and save under one hold of the lock, so concurrent
+    // registrations can't race or land their file writes out of order
+    PROFILED_LOCK(&dataMutex);
+    if (*numCustomers >= MAX_CUSTOMERS) {
+        fprintf(stderr, "Error: Maximum number of customers reached.\n");
+        PROFILED_UNLOCK(&dataMutex);
+        return -1;
+    }
+    for (int i = 0; i < *numCustomers; i++) {
+        if (customers[i].customerID == newCustomer->customerID) {
+            fprintf(stderr, "Error: Customer ID %d already exists.\n", newCustomer->customerID);
+            PROFILED_UNLOCK(&dataMutex);
+            return -1;
+        }
+    }
+
+    customers[*numCustomers] = *newCustomer;
+    indexAddCustomer(newCustomer);
     (*numCustomers)++;
-    saveCustomers(customers, *numCustomers);
-    printf("Customer added successfully!\n");
+    writeCustomersFile(customers, *numCustomers);
+
+    PROFILED_UNLOCK(&dataMutex);
+    return 0;
 }
 
 void editCustomer(Customer *customers, int numCustomers, int customerID) {
-    pthread_mutex_lock(&dataMutex);
+    OP_LATENCY_SCOPE(OP_EDIT_CUSTOMER);
+    PROFILED_LOCK(&dataMutex);
 
     int index = -1;
     for (int i = 0; i < numCustomers; i++) {
@@ -219,6 +265,7 @@ void editCustomer(Customer *customers, int numCustomers, int customerID) {
     if (index == -1) {
         printf("Customer with ID %d not found.\n", customerID);
     } else {
+        Customer before = customers[index];
         printf("Enter new name (leave empty to keep current): ");
         char newName[MAX_NAME_LENGTH];
         scanf("%49s", newName);
@@ -233,20 +280,23 @@ void editCustomer(Customer *customers, int numCustomers, int customerID) {
             strcpy(customers[index].phone, newPhone);
         }
 
-        saveCustomers(customers, numCustomers);
+        indexUpdateCustomer(&before, &customers[index]);
+        writeCustomersFile(customers, numCustomers);
         printf("Customer with ID %d edited successfully.\n", customerID);
     }
 
-    pthread_mutex_unlock(&dataMutex);
+    PROFILED_UNLOCK(&dataMutex);
 }
 
 void deleteCustomer(Customer *customers, int *numCustomers, int customerID) {
-    pthread_mutex_lock(&dataMutex); // Acquire the lock
+    OP_LATENCY_SCOPE(OP_DELETE_CUSTOMER);
+    PROFILED_LOCK(&dataMutex); // Acquire the lock
 
     int found = 0;
     for (int i = 0; i < *numCustomers; i++) {
         if (customers[i].customerID == customerID) {
             found = 1;
+            indexRemoveCustomer(&customers[i]);
 
             // Shift remaining customers to fill the gap
             for (int j = i; j < *numCustomers - 1; j++) {
@@ -254,7 +304,7 @@ void deleteCustomer(Customer *customers, int *numCustomers, int customerID) {
             }
 
             (*numCustomers)--; // Decrement the customer count
-            saveCustomers(customers, *numCustomers); // Save the updated customer data
+            writeCustomersFile(customers, *numCustomers); // Save the updated customer data
             printf("Customer with ID %d deleted successfully.\n", customerID);
             break; // Exit the loop since the customer is found and deleted
         }
@@ -264,58 +314,100 @@ void deleteCustomer(Customer *customers, int *numCustomers, int customerID) {
         printf("Customer with ID %d not found.\n", customerID);
     }
 
-    pthread_mutex_unlock(&dataMutex); // Release the lock
+    PROFILED_UNLOCK(&dataMutex); // Release the lock
 }
 
 Customer* searchCustomerByID(const Customer *customers, int numCustomers, int customerID) {
-    pthread_mutex_lock(&dataMutex);
+    OP_LATENCY_SCOPE(OP_SEARCH_CUSTOMER_ID);
+    PROFILED_LOCK(&dataMutex);
 
     for (int i = 0; i < numCustomers; i++) {
         if (customers[i].customerID == customerID) {
-            pthread_mutex_unlock(&dataMutex);
+            PROFILED_UNLOCK(&dataMutex);
             return (Customer*)&customers[i]; // Return a copy of the found customer
         }
     }
 
-    pthread_mutex_unlock(&dataMutex);
+    PROFILED_UNLOCK(&dataMutex);
     return NULL; // Customer not found
 }
 
+// Identifies the customer through the phone hash index, then fetches the record by ID
+Customer* searchCustomerByPhone(const Customer *customers, int numCustomers, const char *phone) {
+    OP_LATENCY_SCOPE(OP_SEARCH_CUSTOMER_PHONE);
+    int customerID = findCustomerByPhone(phone);
+    if (customerID == 0) {
+        return NULL;
+    }
+    return searchCustomerByID(customers, numCustomers, customerID);
+}
+
+// Name search through the word index: names whose words start with the query's
+// words, or failing that, names within a few typos of them (closest first)
 void searchCustomerByName(const Customer *customers, int numCustomers, const char *name) {
-    pthread_mutex_lock(&dataMutex);
+    OP_LATENCY_SCOPE(OP_SEARCH_CUSTOMER_NAME);
+    int customerIDs[MAX_CUSTOMERS];
+    CustomerMatch matches[MAX_CUSTOMERS];
 
-    int found = 0;
-    printf("\nCustomers found with name '%s':\n", name);
-    for (int i = 0; i < numCustomers; i++) {
-        if (strcasecmp(customers[i].name, name) == 0) { // Case-insensitive comparison
-            displayCustomer(&customers[i]);
-            found = 1;
+    int count = findCustomersByNamePrefix(name, customerIDs, MAX_CUSTOMERS);
+    if (count > 0) {
+        printf("\nCustomers found with name '%s':\n", name);
+    } else {
+        count = findCustomersByNameFuzzy(name, NAME_FUZZY_MAX_DISTANCE, matches, MAX_CUSTOMERS);
+        for (int i = 0; i < count; i++) {
+            customerIDs[i] = matches[i].customerID;
+        }
+        if (count > 0) {
+            printf("\nNo exact match for '%s'. Closest names:\n", name);
         }
     }
-    if (!found) {
+
+    // One writer for the whole result set; records are looked up under one hold of dataMutex
+    ReportWriter out;
+    if (count > 0 && beginStdoutRender(&out) == 0) {
+        PROFILED_LOCK(&dataMutex);
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < numCustomers; j++) {
+                if (customers[j].customerID == customerIDs[i]) {
+                    renderCustomer(&out, &customers[j]);
+                    break;
+                }
+            }
+        }
+        PROFILED_UNLOCK(&dataMutex);
+        endStdoutRender(&out);
+    }
+    if (count == 0) {
         printf("No customers found with the name '%s'.\n", name);
     }
-
-    pthread_mutex_unlock(&dataMutex);
 }
 
 void displayCustomer(const Customer *customer) {
-    printf("Customer ID: %d\n", customer->customerID);
-    printf("Name: %s\n", customer->name);
-    printf("Phone: %s\n", customer->phone);
-    printf("--------------------\n");
+    ReportWriter out;
+    if (beginStdoutRender(&out) == 0) {
+        renderCustomer(&out, customer);
+        endStdoutRender(&out);
+    }
 }
 
-void displayAllCustomers(const Customer *customers, int numCustomers) {
-    pthread_mutex_lock(&dataMutex);
+// Pages through the customers with a cursor; dataMutex is held only while a page is copied
+void displayAllCustomers(const Customer *customers, const int *numCustomers) {
+    ReportWriter out;
+    Customer *page = memAlloc(MEM_REPORTS, RENDER_PAGE_ROWS * sizeof(Customer));
+    if (!page || beginStdoutRender(&out) != 0) {
+        memFree(page);
+        return;
+    }
 
-    if (numCustomers == 0) {
-        printf("No customers found.\n");
-    } else {
-        printf("\nAll Customers:\n");
-        for (int i = 0; i < numCustomers; i++) {
-            displayCustomer(&customers[i]);
+    ListCursor cursor;
+    initListCursor(&cursor, RENDER_PAGE_ROWS, 0);
+    int count = listCustomersPage(customers, numCustomers, &cursor, page);
+    reportWriteString(&out, count == 0 ? "No customers found.\n" : "\nAll Customers:\n");
+    for (; count > 0; count = listCustomersPage(customers, numCustomers, &cursor, page)) {
+        for (int i = 0; i < count; i++) {
+            renderCustomer(&out, &page[i]);
         }
     }
-    pthread_mutex_unlock(&dataMutex);
+    endStdoutRender(&out);
+    memFree(page);
 }
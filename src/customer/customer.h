@@ -1,8 +1,7 @@
 #ifndef CUSTOMER_H
 #define CUSTOMER_H
 
-#include "../book/book.h"
-#include "../sales/sales.h" // Include sales.h to ensure Customer type is recognized
+#include <pthread.h>
 
 #define MAX_CUSTOMERS 100
 #define MAX_NAME_LENGTH 50
@@ -15,15 +14,21 @@ typedef struct {
     char phone[MAX_PHONE_LENGTH];
 } Customer;
 
+extern Customer customers[MAX_CUSTOMERS]; // The customer base (defined in customer.c)
+extern int numCustomers;
+extern pthread_mutex_t dataMutex; // Guards the customer array
+
 // Function prototypes
 void addCustomer(Customer *customers, int *numCustomers);
+int insertCustomer(Customer *customers, int *numCustomers, const Customer *newCustomer);
 void editCustomer(Customer *customers, int numCustomers, int customerID);
 void deleteCustomer(Customer *customers, int *numCustomers, int customerID);
 Customer* searchCustomerByID(const Customer *customers, int numCustomers, int customerID);
+Customer* searchCustomerByPhone(const Customer *customers, int numCustomers, const char *phone);
 void searchCustomerByName(const Customer *customers, int numCustomers, const char *name);
 void displayCustomer(const Customer *customer);
 void saveCustomers(const Customer *customers, int numCustomers);
 void loadCustomers(Customer *customers, int *numCustomers);
-void displayAllCustomers(const Customer *customers, int numCustomers);
+void displayAllCustomers(const Customer *customers, const int *numCustomers); // Count read under dataMutex
 
 #endif // CUSTOMER_H
@@ -0,0 +1,559 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include "customer_index.h"
+#include "../metrics/lock_profile.h"
+
+#define MAX_QUERY_TOKENS 4
+#define MAX_TOKEN_HITS MAX_NAME_WORDS
+#define GRAM_SYMBOLS 37 // Padding, a-z and 0-9
+
+CustomerIndex customerIndex;
+
+// Splits text into lowercase alphanumeric words (truncated to fit); returns how many
+static int tokenizeName(const char *text, char tokens[][MAX_NAME_LENGTH], int maxTokens) {
+    int count = 0;
+    const char *p = text;
+    while (*p != '\0' && count < maxTokens) {
+        while (*p != '\0' && !isalnum((unsigned char)*p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        int length = 0;
+        for (; isalnum((unsigned char)*p); p++) {
+            if (length < MAX_NAME_LENGTH - 1) {
+                tokens[count][length++] = (char)tolower((unsigned char)*p);
+            }
+        }
+        tokens[count][length] = '\0';
+        count++;
+    }
+    return count;
+}
+
+// First slot whose (token, customer ID) is not below the given pair
+static int tokenLowerBound(const char *token, int customerID) {
+    int low = 0, high = customerIndex.tokenCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const NameTokenEntry *entry = &customerIndex.byToken[mid];
+        int order = strcmp(entry->token, token);
+        if (order < 0 || (order == 0 && entry->customerID < customerID)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Letter of a case-folded word as a pair-code digit; 0 is the end padding
+static int gramSymbol(char c) {
+    if (c == '\0') {
+        return 0;
+    }
+    return isdigit((unsigned char)c) ? 27 + (c - '0') : 1 + (c - 'a');
+}
+
+// Distinct padded letter pairs of a word with their counts, sorted by pair; returns how many
+static int wordGrams(const char *word, NameGramEntry *grams) {
+    int count = 0;
+    int previous = 0;
+    for (const char *p = word;; p++) {
+        unsigned short gram = (unsigned short)(previous * GRAM_SYMBOLS + gramSymbol(*p));
+        int pos = count;
+        while (pos > 0 && grams[pos - 1].gram > gram) {
+            pos--;
+        }
+        if (pos > 0 && grams[pos - 1].gram == gram) {
+            grams[pos - 1].occurrences++;
+        } else {
+            memmove(&grams[pos + 1], &grams[pos], (count - pos) * sizeof(NameGramEntry));
+            grams[pos].gram = gram;
+            grams[pos].occurrences = 1;
+            count++;
+        }
+        if (*p == '\0') {
+            return count;
+        }
+        previous = gramSymbol(*p);
+    }
+}
+
+static int gramLowerBound(unsigned short gram, int word) {
+    int low = 0, high = customerIndex.gramCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        const NameGramEntry *entry = &customerIndex.byGram[mid];
+        if (entry->gram < gram || (entry->gram == gram && entry->word < word)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Claims a distinct-word slot and posts its letter pairs; -1 if the table is full
+static int wordAdd(const char *token) {
+    int word = 0;
+    while (word < MAX_NAME_WORDS && customerIndex.words[word][0] != '\0') {
+        word++;
+    }
+    if (word == MAX_NAME_WORDS) {
+        return -1;
+    }
+    strcpy(customerIndex.words[word], token);
+
+    NameGramEntry grams[MAX_NAME_LENGTH];
+    int numGrams = wordGrams(token, grams);
+    for (int g = 0; g < numGrams; g++) {
+        int pos = gramLowerBound(grams[g].gram, word);
+        memmove(&customerIndex.byGram[pos + 1], &customerIndex.byGram[pos],
+                (customerIndex.gramCount - pos) * sizeof(NameGramEntry));
+        customerIndex.byGram[pos] = grams[g];
+        customerIndex.byGram[pos].word = (unsigned short)word;
+        customerIndex.gramCount++;
+    }
+    return word;
+}
+
+// Drops a distinct word no customer uses any more
+static void wordRemove(int word) {
+    NameGramEntry grams[MAX_NAME_LENGTH];
+    int numGrams = wordGrams(customerIndex.words[word], grams);
+    for (int g = 0; g < numGrams; g++) {
+        int pos = gramLowerBound(grams[g].gram, word);
+        if (pos < customerIndex.gramCount && customerIndex.byGram[pos].gram == grams[g].gram &&
+            customerIndex.byGram[pos].word == word) {
+            memmove(&customerIndex.byGram[pos], &customerIndex.byGram[pos + 1],
+                    (customerIndex.gramCount - pos - 1) * sizeof(NameGramEntry));
+            customerIndex.gramCount--;
+        }
+    }
+    customerIndex.words[word][0] = '\0';
+}
+
+// Re-derives the distinct words and their pairs from the sorted token entries
+static void rebuildNameWords(void) {
+    memset(customerIndex.words, 0, sizeof(customerIndex.words));
+    customerIndex.gramCount = 0;
+    for (int i = 0; i < customerIndex.tokenCount; i++) {
+        NameTokenEntry *entry = &customerIndex.byToken[i];
+        if (i > 0 && strcmp(customerIndex.byToken[i - 1].token, entry->token) == 0) {
+            entry->word = customerIndex.byToken[i - 1].word;
+        } else {
+            entry->word = wordAdd(entry->token); // Never full: there are no more words than entries
+        }
+    }
+}
+
+static void tokensInsert(const char *name, int customerID) {
+    char tokens[NAME_TOKENS_PER_CUSTOMER][MAX_NAME_LENGTH];
+    int count = tokenizeName(name, tokens, NAME_TOKENS_PER_CUSTOMER);
+    for (int t = 0; t < count; t++) {
+        int pos = tokenLowerBound(tokens[t], customerID);
+        if (pos < customerIndex.tokenCount && customerIndex.byToken[pos].customerID == customerID &&
+            strcmp(customerIndex.byToken[pos].token, tokens[t]) == 0) {
+            continue; // Repeated word in the same name
+        }
+        if (customerIndex.tokenCount >= MAX_TOKEN_HITS) {
+            fprintf(stderr, "Error: Customer name index full, ID %d not fully indexed.\n", customerID);
+            return;
+        }
+        // Customers sharing a word share its slot, and entries for a word are adjacent
+        int word;
+        if (pos > 0 && strcmp(customerIndex.byToken[pos - 1].token, tokens[t]) == 0) {
+            word = customerIndex.byToken[pos - 1].word;
+        } else if (pos < customerIndex.tokenCount && strcmp(customerIndex.byToken[pos].token, tokens[t]) == 0) {
+            word = customerIndex.byToken[pos].word;
+        } else {
+            word = wordAdd(tokens[t]);
+        }
+        memmove(&customerIndex.byToken[pos + 1], &customerIndex.byToken[pos],
+                (customerIndex.tokenCount - pos) * sizeof(NameTokenEntry));
+        strcpy(customerIndex.byToken[pos].token, tokens[t]);
+        customerIndex.byToken[pos].customerID = customerID;
+        customerIndex.byToken[pos].word = word;
+        customerIndex.tokenCount++;
+    }
+}
+
+// Drops the customer's words; a stale name falls back to a scan by customer ID
+static void tokensRemove(const char *name, int customerID) {
+    char tokens[NAME_TOKENS_PER_CUSTOMER][MAX_NAME_LENGTH];
+    int count = tokenizeName(name, tokens, NAME_TOKENS_PER_CUSTOMER);
+    int stale = 0;
+    for (int t = 0; t < count; t++) {
+        int pos = tokenLowerBound(tokens[t], customerID);
+        if (pos < customerIndex.tokenCount && customerIndex.byToken[pos].customerID == customerID &&
+            strcmp(customerIndex.byToken[pos].token, tokens[t]) == 0) {
+            int word = customerIndex.byToken[pos].word;
+            memmove(&customerIndex.byToken[pos], &customerIndex.byToken[pos + 1],
+                    (customerIndex.tokenCount - pos - 1) * sizeof(NameTokenEntry));
+            customerIndex.tokenCount--;
+            if (!(pos > 0 && customerIndex.byToken[pos - 1].word == word) &&
+                !(pos < customerIndex.tokenCount && customerIndex.byToken[pos].word == word)) {
+                wordRemove(word); // That was its last customer
+            }
+        } else {
+            stale = 1; // Either a repeated word (already removed) or the name was out of date
+        }
+    }
+    if (!stale) {
+        return;
+    }
+    int out = 0;
+    for (int i = 0; i < customerIndex.tokenCount; i++) {
+        if (customerIndex.byToken[i].customerID != customerID) {
+            customerIndex.byToken[out++] = customerIndex.byToken[i];
+        }
+    }
+    customerIndex.tokenCount = out;
+    rebuildNameWords();
+}
+
+// Digits of the number behind a leading 1; 0 if it has no digits or too many
+static unsigned long long packPhone(const char *phone) {
+    unsigned long long key = 1;
+    int digits = 0;
+    for (; *phone != '\0'; phone++) {
+        if (isdigit((unsigned char)*phone)) {
+            if (++digits > PHONE_MAX_DIGITS) {
+                return 0;
+            }
+            key = key * 10 + (unsigned long long)(*phone - '0');
+        }
+    }
+    return digits > 0 ? key : 0;
+}
+
+// Multiplicative hash of a packed phone into the phone table
+static int phoneSlot(unsigned long long key) {
+    return (int)((key * 11400714819323198485ull) >> 32) & (PHONE_TABLE_SIZE - 1);
+}
+
+static void phoneInsert(const char *phone, int customerID) {
+    unsigned long long key = packPhone(phone);
+    if (key == 0) {
+        return; // Nothing to look up by
+    }
+    int slot = phoneSlot(key);
+    for (int probe = 0; probe < PHONE_TABLE_SIZE; probe++) {
+        PhoneEntry *entry = &customerIndex.byPhone[slot];
+        if (entry->phone == 0 || (entry->phone == key && entry->customerID == customerID)) {
+            entry->phone = key;
+            entry->customerID = customerID;
+            return;
+        }
+        slot = (slot + 1) & (PHONE_TABLE_SIZE - 1);
+    }
+    fprintf(stderr, "Error: Phone index full, ID %d not indexed.\n", customerID);
+}
+
+// Empties a slot and shifts later entries of the probe run back over it, so
+// lookups never need tombstones
+static void phoneEraseSlot(int hole) {
+    customerIndex.byPhone[hole].phone = 0;
+    int slot = (hole + 1) & (PHONE_TABLE_SIZE - 1);
+    while (customerIndex.byPhone[slot].phone != 0) {
+        int home = phoneSlot(customerIndex.byPhone[slot].phone);
+        if (((slot - home) & (PHONE_TABLE_SIZE - 1)) >= ((slot - hole) & (PHONE_TABLE_SIZE - 1))) {
+            customerIndex.byPhone[hole] = customerIndex.byPhone[slot];
+            customerIndex.byPhone[slot].phone = 0;
+            hole = slot;
+        }
+        slot = (slot + 1) & (PHONE_TABLE_SIZE - 1);
+    }
+}
+
+// Removes the customer's entry; a stale number falls back to a scan by customer ID
+static void phoneRemove(const char *phone, int customerID) {
+    unsigned long long key = packPhone(phone);
+    if (key != 0) {
+        int slot = phoneSlot(key);
+        for (int probe = 0; probe < PHONE_TABLE_SIZE && customerIndex.byPhone[slot].phone != 0; probe++) {
+            if (customerIndex.byPhone[slot].phone == key && customerIndex.byPhone[slot].customerID == customerID) {
+                phoneEraseSlot(slot);
+                return;
+            }
+            slot = (slot + 1) & (PHONE_TABLE_SIZE - 1);
+        }
+    }
+    for (int slot = 0; slot < PHONE_TABLE_SIZE; slot++) {
+        if (customerIndex.byPhone[slot].phone != 0 && customerIndex.byPhone[slot].customerID == customerID) {
+            phoneEraseSlot(slot);
+            return;
+        }
+    }
+}
+
+void rebuildCustomerIndex(const Customer *customers, int numCustomers) {
+    customerIndex.tokenCount = 0;
+    customerIndex.gramCount = 0;
+    memset(customerIndex.words, 0, sizeof(customerIndex.words));
+    memset(customerIndex.byPhone, 0, sizeof(customerIndex.byPhone));
+    for (int i = 0; i < numCustomers; i++) {
+        indexAddCustomer(&customers[i]);
+    }
+}
+
+void indexAddCustomer(const Customer *customer) {
+    tokensInsert(customer->name, customer->customerID);
+    phoneInsert(customer->phone, customer->customerID);
+}
+
+void indexRemoveCustomer(const Customer *customer) {
+    tokensRemove(customer->name, customer->customerID);
+    phoneRemove(customer->phone, customer->customerID);
+}
+
+void indexUpdateCustomer(const Customer *before, const Customer *after) {
+    if (strcmp(before->name, after->name) != 0 || before->customerID != after->customerID) {
+        tokensRemove(before->name, before->customerID);
+        tokensInsert(after->name, after->customerID);
+    }
+    if (strcmp(before->phone, after->phone) != 0 || before->customerID != after->customerID) {
+        phoneRemove(before->phone, before->customerID);
+        phoneInsert(after->phone, after->customerID);
+    }
+}
+
+// Edit distance counting insertions, deletions, substitutions and swaps of
+// adjacent letters; gives up with bound + 1 as soon as the bound can't be met
+static int boundedEditDistance(const char *a, const char *b, int bound) {
+    int lengthA = (int)strlen(a), lengthB = (int)strlen(b);
+    if (abs(lengthA - lengthB) > bound) {
+        return bound + 1;
+    }
+
+    int rows[3][MAX_NAME_LENGTH + 1];
+    int *older = rows[0], *previous = rows[1], *current = rows[2];
+    for (int j = 0; j <= lengthB; j++) {
+        previous[j] = j;
+    }
+    int previousMin = 0;
+    for (int i = 1; i <= lengthA; i++) {
+        current[0] = i;
+        int rowMin = i;
+        for (int j = 1; j <= lengthB; j++) {
+            int best = previous[j - 1] + (a[i - 1] != b[j - 1]);
+            if (previous[j] + 1 < best) {
+                best = previous[j] + 1;
+            }
+            if (current[j - 1] + 1 < best) {
+                best = current[j - 1] + 1;
+            }
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && older[j - 2] + 1 < best) {
+                best = older[j - 2] + 1;
+            }
+            current[j] = best;
+            if (best < rowMin) {
+                rowMin = best;
+            }
+        }
+        // A swap reaches back two rows, so both must be out of reach
+        if (rowMin > bound && previousMin >= bound) {
+            return bound + 1;
+        }
+        previousMin = rowMin;
+        int *spare = older;
+        older = previous;
+        previous = current;
+        current = spare;
+    }
+    return previous[lengthB] <= bound ? previous[lengthB] : bound + 1;
+}
+
+static int compareMatchByID(const void *a, const void *b) {
+    const CustomerMatch *x = a, *y = b;
+    if (x->customerID != y->customerID) {
+        return x->customerID < y->customerID ? -1 : 1;
+    }
+    return x->distance - y->distance;
+}
+
+static int compareMatchByDistance(const void *a, const void *b) {
+    const CustomerMatch *x = a, *y = b;
+    if (x->distance != y->distance) {
+        return x->distance - y->distance;
+    }
+    return x->customerID < y->customerID ? -1 : (x->customerID > y->customerID);
+}
+
+// Sorts hits by customer ID and keeps each customer's closest word
+static int uniqueHits(CustomerMatch *hits, int count) {
+    qsort(hits, count, sizeof(CustomerMatch), compareMatchByID);
+    int out = 0;
+    for (int i = 0; i < count; i++) {
+        if (out == 0 || hits[out - 1].customerID != hits[i].customerID) {
+            hits[out++] = hits[i];
+        }
+    }
+    return out;
+}
+
+// Customers with a word starting with prefix, from one walk of the sorted words
+static int collectPrefixHits(const char *prefix, CustomerMatch *hits) {
+    size_t length = strlen(prefix);
+    int count = 0;
+    for (int i = tokenLowerBound(prefix, INT_MIN);
+         i < customerIndex.tokenCount && strncmp(customerIndex.byToken[i].token, prefix, length) == 0; i++) {
+        hits[count].customerID = customerIndex.byToken[i].customerID;
+        hits[count].distance = 0;
+        count++;
+    }
+    return uniqueHits(hits, count);
+}
+
+// Customers with a word within bound edits of word. Candidates come from the
+// pair postings: an insertion, deletion or substitution spoils at most two of the
+// query word's padded pairs and a swap three, so a word within bound edits shares
+// at least (length + 1) - 3 * bound of them. Only candidates reaching that count
+// are compared; when the count is not positive every distinct word is.
+static int collectFuzzyHits(const char *word, int bound, CustomerMatch *hits) {
+    static __thread unsigned short shared[MAX_NAME_WORDS];
+    static __thread int candidates[MAX_NAME_WORDS];
+    int needed = (int)strlen(word) + 1 - 3 * bound;
+    int numCandidates = 0;
+
+    if (needed > 0) {
+        NameGramEntry grams[MAX_NAME_LENGTH];
+        int numGrams = wordGrams(word, grams);
+        memset(shared, 0, sizeof(shared));
+        for (int g = 0; g < numGrams; g++) {
+            for (int i = gramLowerBound(grams[g].gram, 0);
+                 i < customerIndex.gramCount && customerIndex.byGram[i].gram == grams[g].gram; i++) {
+                const NameGramEntry *posting = &customerIndex.byGram[i];
+                int before = shared[posting->word];
+                shared[posting->word] += posting->occurrences < grams[g].occurrences ? posting->occurrences
+                                                                                     : grams[g].occurrences;
+                if (before < needed && shared[posting->word] >= needed) {
+                    candidates[numCandidates++] = posting->word;
+                }
+            }
+        }
+    } else {
+        for (int w = 0; w < MAX_NAME_WORDS; w++) {
+            if (customerIndex.words[w][0] != '\0') {
+                candidates[numCandidates++] = w;
+            }
+        }
+    }
+
+    int count = 0;
+    for (int c = 0; c < numCandidates; c++) {
+        const char *token = customerIndex.words[candidates[c]];
+        int distance = boundedEditDistance(word, token, bound);
+        if (distance > bound) {
+            continue;
+        }
+        for (int i = tokenLowerBound(token, INT_MIN);
+             i < customerIndex.tokenCount && customerIndex.byToken[i].word == candidates[c]; i++) {
+            hits[count].customerID = customerIndex.byToken[i].customerID;
+            hits[count].distance = distance;
+            count++;
+        }
+    }
+    return uniqueHits(hits, count);
+}
+
+// Keeps the customers present in both ID-sorted lists, adding their distances
+static int intersectHits(CustomerMatch *matches, int count, const CustomerMatch *hits, int hitCount) {
+    int out = 0, i = 0, j = 0;
+    while (i < count && j < hitCount) {
+        if (matches[i].customerID < hits[j].customerID) {
+            i++;
+        } else if (matches[i].customerID > hits[j].customerID) {
+            j++;
+        } else {
+            matches[out].customerID = matches[i].customerID;
+            matches[out].distance = matches[i].distance + hits[j].distance;
+            out++;
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
+
+// Candidates matching every query word, sorted by customer ID; maxDistance < 0 means prefix matching
+static int matchQuery(const char *query, int maxDistance, CustomerMatch *matches) {
+    static __thread CustomerMatch hits[MAX_TOKEN_HITS];
+    char words[MAX_QUERY_TOKENS][MAX_NAME_LENGTH];
+    int numWords = tokenizeName(query, words, MAX_QUERY_TOKENS);
+    int count = 0;
+    for (int w = 0; w < numWords; w++) {
+        int bound = (int)strlen(words[w]) <= 4 && maxDistance > 1 ? 1 : maxDistance;
+        int hitCount = maxDistance < 0 ? collectPrefixHits(words[w], hits) : collectFuzzyHits(words[w], bound, hits);
+        if (w == 0) {
+            memcpy(matches, hits, hitCount * sizeof(CustomerMatch));
+            count = hitCount;
+        } else {
+            count = intersectHits(matches, count, hits, hitCount);
+        }
+        if (count == 0) {
+            break;
+        }
+    }
+    return count;
+}
+
+// Function to find customers by the beginnings of their name words
+int findCustomersByNamePrefix(const char *query, int *customerIDs, int maxResults) {
+    static __thread CustomerMatch matches[MAX_TOKEN_HITS];
+    PROFILED_LOCK(&dataMutex);
+    int count = matchQuery(query, -1, matches);
+    PROFILED_UNLOCK(&dataMutex);
+
+    if (count > maxResults) {
+        count = maxResults;
+    }
+    for (int i = 0; i < count; i++) {
+        customerIDs[i] = matches[i].customerID;
+    }
+    return count;
+}
+
+// Function to find customers whose name words are close to the query's, closest first
+int findCustomersByNameFuzzy(const char *query, int maxDistance, CustomerMatch *matches, int maxResults) {
+    static __thread CustomerMatch candidates[MAX_TOKEN_HITS];
+    if (maxDistance < 0) {
+        return 0;
+    }
+    PROFILED_LOCK(&dataMutex);
+    int count = matchQuery(query, maxDistance, candidates);
+    PROFILED_UNLOCK(&dataMutex);
+
+    qsort(candidates, count, sizeof(CustomerMatch), compareMatchByDistance);
+    if (count > maxResults) {
+        count = maxResults;
+    }
+    memcpy(matches, candidates, count * sizeof(CustomerMatch));
+    return count;
+}
+
+// Function to identify a customer by phone with one hash probe run
+int findCustomerByPhone(const char *phone) {
+    unsigned long long key = packPhone(phone);
+    if (key == 0) {
+        return 0;
+    }
+
+    int customerID = 0;
+    PROFILED_LOCK(&dataMutex);
+    int slot = phoneSlot(key);
+    for (int probe = 0; probe < PHONE_TABLE_SIZE && customerIndex.byPhone[slot].phone != 0; probe++) {
+        const PhoneEntry *entry = &customerIndex.byPhone[slot];
+        if (entry->phone == key && (customerID == 0 || entry->customerID < customerID)) {
+            customerID = entry->customerID;
+        }
+        slot = (slot + 1) & (PHONE_TABLE_SIZE - 1);
+    }
+    PROFILED_UNLOCK(&dataMutex);
+    return customerID;
+}
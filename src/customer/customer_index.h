@@ -0,0 +1,71 @@
+#ifndef CUSTOMER_INDEX_H
+#define CUSTOMER_INDEX_H
+
+#include "customer.h"
+
+#define NAME_TOKENS_PER_CUSTOMER 4 // Name words indexed per customer
+#define NAME_FUZZY_MAX_DISTANCE 2  // Edit budget per query word (1 for words of four letters or fewer)
+#define PHONE_TABLE_SIZE 256       // Must be a power of two and at least twice MAX_CUSTOMERS
+#define PHONE_MAX_DIGITS 18        // Longest number that packs into a key
+#define MAX_NAME_WORDS (MAX_CUSTOMERS * NAME_TOKENS_PER_CUSTOMER)
+#define MAX_NAME_GRAMS (MAX_NAME_WORDS * MAX_NAME_LENGTH) // A word of n letters has n + 1 padded pairs
+
+// One case-folded name word; entries are sorted by (token, customer ID)
+typedef struct {
+    char token[MAX_NAME_LENGTH];
+    int customerID;
+    int word; // Slot of the token in the distinct-word table
+} NameTokenEntry;
+
+// Posting of a letter pair (the word's ends padded) in a distinct word; entries
+// are sorted by (gram, word), so each pair's words are adjacent
+typedef struct {
+    unsigned short gram;
+    unsigned short word;
+    unsigned short occurrences;
+} NameGramEntry;
+
+// Phone digits packed behind a leading 1 (so leading zeros survive) into one
+// integer key; 0 marks an empty slot
+typedef struct {
+    unsigned long long phone;
+    int customerID;
+} PhoneEntry;
+
+// Guarded by dataMutex, like the customer array it mirrors
+typedef struct {
+    NameTokenEntry byToken[MAX_NAME_WORDS];
+    int tokenCount;
+    char words[MAX_NAME_WORDS][MAX_NAME_LENGTH]; // Distinct tokens; an empty string marks a free slot
+    NameGramEntry byGram[MAX_NAME_GRAMS];         // Letter-pair postings that pick fuzzy candidates
+    int gramCount;
+    PhoneEntry byPhone[PHONE_TABLE_SIZE]; // Open addressing with linear probing
+} CustomerIndex;
+
+typedef struct {
+    int customerID;
+    int distance; // Total edits across the query words; 0 for prefix matches
+} CustomerMatch;
+
+extern CustomerIndex customerIndex;
+
+// Function prototypes (declarations)
+// Maintenance; the caller holds dataMutex
+void rebuildCustomerIndex(const Customer *customers, int numCustomers);
+void indexAddCustomer(const Customer *customer);
+void indexRemoveCustomer(const Customer *customer);
+void indexUpdateCustomer(const Customer *before, const Customer *after);
+
+// Every query word must start some word of the name ("joh smi" finds John Smith).
+// Fills customer IDs in ascending order; takes dataMutex itself.
+int findCustomersByNamePrefix(const char *query, int *customerIDs, int maxResults);
+// Every query word must be within maxDistance edits (at most 1 for words of four
+// letters or fewer) of some word of the name. Only words sharing enough letter
+// pairs with the query word are compared. Results are ranked by total
+// distance, then customer ID; takes dataMutex itself.
+int findCustomersByNameFuzzy(const char *query, int maxDistance, CustomerMatch *matches, int maxResults);
+// Customer ID registered with the number (formatting such as spaces or dashes is
+// ignored), or 0 if none; the lowest ID wins when several share it. Takes dataMutex itself.
+int findCustomerByPhone(const char *phone);
+
+#endif // CUSTOMER_INDEX_H
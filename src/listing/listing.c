@@ -0,0 +1,168 @@
+#include <string.h>
+#include <stddef.h>
+#include "listing.h"
+#include "../metrics/lock_profile.h"
+
+// Key and slot of one record chosen for a page
+typedef struct {
+    int key;
+    int index;
+} PageSlot;
+
+void initListCursor(ListCursor *cursor, int pageSize, int ordered) {
+    memset(cursor, 0, sizeof(*cursor));
+    if (pageSize < 1) {
+        pageSize = 1;
+    }
+    cursor->pageSize = pageSize < LIST_MAX_PAGE_SIZE ? pageSize : LIST_MAX_PAGE_SIZE;
+    cursor->ordered = ordered;
+}
+
+void resumeListCursor(ListCursor *cursor, int pageSize, int afterKey) {
+    initListCursor(cursor, pageSize, 1);
+    cursor->lastKey = afterKey;
+    cursor->started = 1;
+}
+
+static int keyAt(const char *records, size_t size, size_t keyOffset, int index) {
+    int key;
+    memcpy(&key, records + (size_t)index * size + keyOffset, sizeof(int));
+    return key;
+}
+
+// Max-heap on key, so the root is the largest key kept so far
+static void siftDown(PageSlot *heap, int count, int pos) {
+    for (;;) {
+        int largest = pos, left = 2 * pos + 1, right = left + 1;
+        if (left < count && heap[left].key > heap[largest].key) {
+            largest = left;
+        }
+        if (right < count && heap[right].key > heap[largest].key) {
+            largest = right;
+        }
+        if (largest == pos) {
+            return;
+        }
+        PageSlot swap = heap[pos];
+        heap[pos] = heap[largest];
+        heap[largest] = swap;
+        pos = largest;
+    }
+}
+
+static void siftUp(PageSlot *heap, int pos) {
+    while (pos > 0 && heap[(pos - 1) / 2].key < heap[pos].key) {
+        PageSlot swap = heap[pos];
+        heap[pos] = heap[(pos - 1) / 2];
+        heap[(pos - 1) / 2] = swap;
+        pos = (pos - 1) / 2;
+    }
+}
+
+// The pageSize smallest keys above the cursor, ascending: one pass with a
+// bounded heap, O(n log pageSize) time and O(pageSize) memory
+static int selectOrderedPage(const char *records, int count, size_t size, size_t keyOffset,
+                             const ListCursor *cursor, PageSlot *slots) {
+    int filled = 0;
+    for (int i = 0; i < count; i++) {
+        int key = keyAt(records, size, keyOffset, i);
+        if (cursor->started && key <= cursor->lastKey) {
+            continue;
+        }
+        if (filled < cursor->pageSize) {
+            slots[filled].key = key;
+            slots[filled].index = i;
+            siftUp(slots, filled++);
+        } else if (key < slots[0].key) {
+            slots[0].key = key;
+            slots[0].index = i;
+            siftDown(slots, filled, 0);
+        }
+    }
+
+    // Heap sort in place: the max-heap unwinds into ascending order
+    for (int end = filled - 1; end > 0; end--) {
+        PageSlot swap = slots[0];
+        slots[0] = slots[end];
+        slots[end] = swap;
+        siftDown(slots, end, 0);
+    }
+    return filled;
+}
+
+// The next pageSize records in storage order after the last one returned
+static int selectStoragePage(const char *records, int count, size_t size, size_t keyOffset,
+                             const ListCursor *cursor, PageSlot *slots) {
+    int start = 0;
+    if (cursor->started) {
+        start = cursor->position < count ? cursor->position : count;
+        // Deletes shift records left, so the last record is at or below its old slot
+        for (int i = start - 1; i >= 0; i--) {
+            if (keyAt(records, size, keyOffset, i) == cursor->lastKey) {
+                start = i + 1;
+                break;
+            }
+        }
+    }
+
+    int filled = 0;
+    for (int i = start; i < count && filled < cursor->pageSize; i++) {
+        slots[filled].key = keyAt(records, size, keyOffset, i);
+        slots[filled].index = i;
+        filled++;
+    }
+    return filled;
+}
+
+// Copy the chosen records out (caller holds the store's lock)
+static int gatherPage(const void *records, int count, size_t size, size_t keyOffset, ListCursor *cursor,
+                      void *out, PageSlot *slots) {
+    if (cursor->done) {
+        return 0;
+    }
+    int filled = cursor->ordered ? selectOrderedPage(records, count, size, keyOffset, cursor, slots)
+                                 : selectStoragePage(records, count, size, keyOffset, cursor, slots);
+    for (int i = 0; i < filled; i++) {
+        memcpy((char *)out + (size_t)i * size, (const char *)records + (size_t)slots[i].index * size, size);
+    }
+    return filled;
+}
+
+static void advanceCursor(ListCursor *cursor, const PageSlot *slots, int filled) {
+    if (filled > 0) {
+        cursor->lastKey = slots[filled - 1].key;
+        cursor->position = slots[filled - 1].index + 1;
+        cursor->started = 1;
+    }
+    if (filled < cursor->pageSize) {
+        cursor->done = 1;
+    }
+}
+
+int listBooksPage(const Book *books, const int *numBooks, ListCursor *cursor, Book *out) {
+    PageSlot slots[LIST_MAX_PAGE_SIZE];
+    PROFILED_LOCK(&bookMutex);
+    int filled = gatherPage(books, *numBooks, sizeof(Book), offsetof(Book, ISBN), cursor, out, slots);
+    PROFILED_UNLOCK(&bookMutex);
+    advanceCursor(cursor, slots, filled);
+    return filled;
+}
+
+int listCustomersPage(const Customer *customers, const int *numCustomers, ListCursor *cursor, Customer *out) {
+    PageSlot slots[LIST_MAX_PAGE_SIZE];
+    PROFILED_LOCK(&dataMutex);
+    int filled = gatherPage(customers, *numCustomers, sizeof(Customer), offsetof(Customer, customerID), cursor, out,
+                            slots);
+    PROFILED_UNLOCK(&dataMutex);
+    advanceCursor(cursor, slots, filled);
+    return filled;
+}
+
+int listSalesPage(const Sale *sales, const int *numSales, ListCursor *cursor, Sale *out) {
+    PageSlot slots[LIST_MAX_PAGE_SIZE];
+    PROFILED_LOCK(&bookMutex); // Checkouts append sales under bookMutex
+    int filled = gatherPage(sales, *numSales, sizeof(Sale), offsetof(Sale, saleID), cursor, out, slots);
+    PROFILED_UNLOCK(&bookMutex);
+    advanceCursor(cursor, slots, filled);
+    return filled;
+}
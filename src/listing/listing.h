@@ -0,0 +1,36 @@
+#ifndef LISTING_H
+#define LISTING_H
+
+#include "../book/book.h"
+#include "../customer/customer.h"
+#include "../sales/sales.h"
+
+#define LIST_MAX_PAGE_SIZE 1024
+
+// Position in a paginated listing. Ordered cursors resume strictly after the
+// last key seen, so they stay stable while records are added or deleted
+// between pages. Storage-order cursors resume after the last record's current
+// slot (found again by key); if that record was deleted meanwhile, they resume
+// at its old slot, so a record can be skipped or repeated.
+typedef struct {
+    int pageSize;
+    int ordered;  // 1: ascending by key (ISBN, customer ID, sale ID); 0: storage order
+    int lastKey;  // Key of the last record returned
+    int position; // Storage-order resume slot
+    int started;  // lastKey is set
+    int done;     // A page came back short; nothing further to fetch
+} ListCursor;
+
+// Function prototypes (declarations)
+void initListCursor(ListCursor *cursor, int pageSize, int ordered);
+void resumeListCursor(ListCursor *cursor, int pageSize, int afterKey); // Ordered cursor from a saved key
+
+// Copy the next page (at most pageSize records) into out and advance the
+// cursor. Each call holds the store's lock only while the page is gathered,
+// and reads the record count through the pointer under that lock.
+// Returns the number of records copied; 0 once the listing is exhausted.
+int listBooksPage(const Book *books, const int *numBooks, ListCursor *cursor, Book *out);
+int listCustomersPage(const Customer *customers, const int *numCustomers, ListCursor *cursor, Customer *out);
+int listSalesPage(const Sale *sales, const int *numSales, ListCursor *cursor, Sale *out); // Sales are guarded by bookMutex
+
+#endif // LISTING_H
@@ -2,24 +2,37 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
 #include "book/book.h"
+#include "book/book_import.h"
+#include "book/book_bulk.h"
+#include "book/book_index.h"
+#include "book/book_fuzzy.h"
 #include "customer/customer.h"
+#include "customer/customer_index.h"
 #include "sales/sales.h"
+#include "sales/sales_stats.h"
+#include "sales/sales_aggregate.h"
+#include "sales/sales_rollup.h"
+#include "sales/sales_topk.h"
+#include "sales/sales_report.h"
+#include "sales/sales_ingest.h"
+#include "batch/batch.h"
+#include "metrics/op_latency.h"
+#include "metrics/lock_profile.h"
+#include "metrics/trace.h"
+#include "metrics/mem_account.h"
 
 #define CUSTOMERS_DATA_FILE "data/customers.csv"
 #define MAX_BOOKS 100
 #define MAX_SALES 100
 
-Book books[MAX_BOOKS];
-int numBooks = 0;
-Customer customers[MAX_CUSTOMERS];
-int numCustomers = 0;
+// Books, customers and their mutexes live in book.c and customer.c
 Sale sales[MAX_SALES];
 int numSales = 0;
-pthread_mutex_t dataMutex = PTHREAD_MUTEX_INITIALIZER;
 
 // Book Management Menu Function
-void bookManagementMenu(Book *books, int *numBooks, pthread_mutex_t *dataMutex) {
+void bookManagementMenu(Book *books, int *numBooks) {
     int choice, ISBN;
     char title[MAX_TITLE_LENGTH];
 
@@ -31,6 +44,11 @@ void bookManagementMenu(Book *books, int *numBooks, pthread_mutex_t *dataMutex)
         printf("4. Search Book by ISBN\n");
         printf("5. Search Book by Title\n");
         printf("6. Display All Books\n");
+        printf("7. Import Catalog Feed\n");
+        printf("8. Bulk Reprice / Restock\n");
+        printf("9. Find Books by Price Range\n");
+        printf("10. Low Stock Report\n");
+        printf("11. Search Book by Author\n");
         printf("0. Back\n");
         printf("Enter your choice: ");
         if (scanf("%d", &choice) != 1) {
@@ -39,70 +57,156 @@ void bookManagementMenu(Book *books, int *numBooks, pthread_mutex_t *dataMutex)
             continue;
         }
 
+        // The book functions take bookMutex themselves
         switch (choice) {
             case 1: // Add Book
-                pthread_mutex_lock(dataMutex);
                 addBook(books, numBooks);
-                pthread_mutex_unlock(dataMutex);
                 break;
             case 2: // Edit Book
-                pthread_mutex_lock(dataMutex);
                 printf("Enter ISBN of book to edit: ");
                 if (scanf("%d", &ISBN) != 1) {
                     fprintf(stderr, "Error: Invalid ISBN input.\n");
                     while (getchar() != '\n');
                 } else {
-                    editBook(books, *numBooks);
+                    editBook(books, *numBooks, ISBN);
                 }
-                pthread_mutex_unlock(dataMutex);
                 break;
             case 3: // Delete Book
-                pthread_mutex_lock(dataMutex);
                 printf("Enter ISBN of book to delete: ");
                 if (scanf("%d", &ISBN) != 1) {
                     fprintf(stderr, "Error: Invalid ISBN input.\n");
                     while (getchar() != '\n');
                 } else {
-                    deleteBook(books, numBooks);
+                    deleteBook(books, numBooks, ISBN);
                 }
-                pthread_mutex_unlock(dataMutex);
                 break;
             case 4: // Search Book by ISBN
-                pthread_mutex_lock(dataMutex);
                 printf("Enter ISBN to search: ");
                 if (scanf("%d", &ISBN) != 1) {
                     fprintf(stderr, "Error: Invalid ISBN input.\n");
                     while (getchar() != '\n');
                 } else {
-                    Book *foundBook = searchBookByISBN(books, *numBooks, ISBN);
-                    if (foundBook) {
-                        displayBook(foundBook);
+                    if (searchBookByISBN(books, *numBooks, ISBN)) {
+                        displayBooksByISBN(books, *numBooks, &ISBN, 1); // Renders under bookMutex
                     } else {
                         printf("Book not found.\n");
                     }
                 }
-                pthread_mutex_unlock(dataMutex);
                 break;
             case 5: // Search Book by Title
-                pthread_mutex_lock(dataMutex);
                 printf("Enter title to search: ");
                 scanf("%s", title); // Assuming title doesn't have spaces
                 Book *foundBooks = searchBookByTitle(books, *numBooks, title);
                 if (foundBooks) {
-                    for (int i = 0; foundBooks[i].ISBN != 0; i++) {
-                        displayBook(&foundBooks[i]);
+                    int count = 0;
+                    while (foundBooks[count].ISBN != 0) {
+                        count++;
                     }
+                    displayBookList(foundBooks, count);
                     free(foundBooks); // Free the memory allocated in searchBookByTitle
                 } else {
-                    printf("Book not found.\n");
+                    // No exact match: fall back to typo-tolerant search, closest first
+                    TitleMatch matches[MAX_BOOKS];
+                    int ISBNs[MAX_BOOKS];
+                    int count = searchBooksByTitleFuzzy(books, *numBooks, title, -1, 0, matches, MAX_BOOKS);
+                    if (count > 0) {
+                        printf("No exact match. Closest titles:\n");
+                    } else {
+                        printf("Book not found.\n");
+                    }
+                    for (int i = 0; i < count; i++) {
+                        ISBNs[i] = matches[i].ISBN;
+                    }
+                    displayBooksByISBN(books, *numBooks, ISBNs, count);
                 }
-                pthread_mutex_unlock(dataMutex);
                 break;
             case 6: // Display All Books
-                pthread_mutex_lock(dataMutex);
-                displayAllBooks(books, *numBooks);
-                pthread_mutex_unlock(dataMutex);
+                displayAllBooks(books, numBooks); // Pages under bookMutex itself
+                break;
+            case 7: { // Import Catalog Feed
+                char path[256];
+                ImportResult result;
+                printf("Enter feed file: ");
+                scanf("%255s", path);
+                if (importCatalog(path, books, numBooks, &result) == 0) {
+                    printf("Read %ld rows: %ld inserted, %ld updated, %ld duplicates, %ld rejected.\n",
+                           result.rowsRead, result.inserted, result.updated, result.duplicates, result.rejected);
+                }
+                break;
+            }
+            case 8: { // Bulk Reprice / Restock
+                char author[MAX_AUTHOR_LENGTH];
+                int mode;
+                float amount;
+                BookFilter filter = {NULL, 0.0f, 0.0f, -1};
+                printf("Author to match (- for any): ");
+                scanf("%49s", author);
+                if (strcmp(author, "-") != 0) {
+                    filter.author = author;
+                }
+                printf("Only books priced below (0 for any): ");
+                if (scanf("%f", &filter.maxPrice) != 1) {
+                    fprintf(stderr, "Error: Invalid price input.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                printf("1. Adjust price by percent\n2. Adjust quantity by amount\nChoice and amount: ");
+                if (scanf("%d %f", &mode, &amount) != 2 || (mode != 1 && mode != 2)) {
+                    fprintf(stderr, "Error: Invalid input.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                int changed = mode == 1 ? bulkAdjustPrice(books, *numBooks, &filter, amount)
+                                        : bulkAdjustQuantity(books, *numBooks, &filter, (int)amount);
+                printf("%d book(s) updated.\n", changed);
+                break;
+            }
+            case 9: { // Find Books by Price Range
+                float minPrice, maxPrice;
+                int matches[MAX_BOOKS];
+                printf("Enter minimum and maximum price: ");
+                if (scanf("%f %f", &minPrice, &maxPrice) != 2 || minPrice > maxPrice) {
+                    fprintf(stderr, "Error: Invalid price range.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                int count = findBooksByPriceRange(minPrice, maxPrice, matches, MAX_BOOKS);
+                displayBooksByISBN(books, *numBooks, matches, count);
+                printf("%d book(s) priced %.2f to %.2f.\n", count, minPrice, maxPrice);
+                break;
+            }
+            case 10: { // Low Stock Report
+                int threshold;
+                int matches[MAX_BOOKS];
+                printf("Report books with fewer than how many copies (0 for %d): ", LOW_STOCK_THRESHOLD);
+                if (scanf("%d", &threshold) != 1) {
+                    fprintf(stderr, "Error: Invalid quantity input.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                if (threshold <= 0) {
+                    threshold = LOW_STOCK_THRESHOLD;
+                }
+                int count = findLowStockBooks(threshold, matches, MAX_BOOKS);
+                displayBooksByISBN(books, *numBooks, matches, count);
+                printf("%d book(s) below %d copies.\n", count, threshold);
                 break;
+            }
+            case 11: { // Search Book by Author
+                char author[MAX_AUTHOR_LENGTH];
+                int matches[MAX_BOOKS];
+                printf("Enter author name or its beginning: ");
+                if (scanf(" %49[^\n]", author) != 1) {
+                    fprintf(stderr, "Error: Invalid author input.\n");
+                    break;
+                }
+                int count = findBooksByAuthorPrefix(author, matches, MAX_BOOKS);
+                displayBooksByISBN(books, *numBooks, matches, count);
+                if (count == 0) {
+                    printf("Book not found.\n");
+                }
+                break;
+            }
             case 0: // Back
                 printf("Back to main menu.\n");
                 break;
@@ -114,7 +218,7 @@ void bookManagementMenu(Book *books, int *numBooks, pthread_mutex_t *dataMutex)
 
 
 // Customer Management Menu Function (Similar to Book Management)
-void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mutex_t *dataMutex) {
+void customerManagementMenu(Customer *customers, int *numCustomers) {
     int choice, customerID;
     char name[MAX_NAME_LENGTH]; // Use the global MAX_NAME_LENGTH from customer.h
 
@@ -126,6 +230,7 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
             printf("4. Search Customer by ID\n");
             printf("5. Search Customers by Name\n");
             printf("6. Display All Customers\n");
+            printf("7. Search Customer by Phone\n");
             printf("0. Back\n");
             printf("Enter your choice: ");
 
@@ -135,15 +240,13 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
                 continue;
             }
 
+            // The customer functions take dataMutex themselves
             switch (choice) {
                 case 1: // Add Customer
-                    pthread_mutex_lock(dataMutex);
                     addCustomer(customers, numCustomers);
-                    pthread_mutex_unlock(dataMutex);
                     break;
 
                 case 2: // Edit Customer
-                    pthread_mutex_lock(dataMutex);
                     printf("Enter customer ID to edit: ");
                     if (scanf("%d", &customerID) != 1) {
                         fprintf(stderr, "Error: Invalid customer ID input.\n");
@@ -151,11 +254,9 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
                     } else {
                         editCustomer(customers, *numCustomers, customerID);
                     }
-                    pthread_mutex_unlock(dataMutex);
                     break;
 
                 case 3: // Delete Customer
-                    pthread_mutex_lock(dataMutex);
                     printf("Enter customer ID to delete: ");
                     if (scanf("%d", &customerID) != 1) {
                         fprintf(stderr, "Error: Invalid customer ID input.\n");
@@ -163,11 +264,9 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
                     } else {
                         deleteCustomer(customers, numCustomers, customerID);
                     }
-                    pthread_mutex_unlock(dataMutex);
                     break;
 
                 case 4: // Search Customer by ID
-                    pthread_mutex_lock(dataMutex);
                     printf("Enter customer ID to search: ");
                     if (scanf("%d", &customerID) != 1) {
                         fprintf(stderr, "Error: Invalid customer ID input.\n");
@@ -180,23 +279,31 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
                             printf("Customer not found.\n");
                         }
                     }
-                    pthread_mutex_unlock(dataMutex);
                     break;
 
                 case 5: // Search Customers by Name
-                    pthread_mutex_lock(dataMutex);
                     printf("Enter name to search: ");
-                    scanf("%s", name);
+                    scanf(" %49[^\n]", name); // Whole or partial name, several words allowed
                     searchCustomerByName(customers, *numCustomers, name); // Assuming this function handles multiple results
-                    pthread_mutex_unlock(dataMutex);
                     break;
 
                 case 6: // Display All Customers
-                    pthread_mutex_lock(dataMutex);
-                    displayAllCustomers(customers, *numCustomers);
-                    pthread_mutex_unlock(dataMutex);
+                    displayAllCustomers(customers, numCustomers);
                     break;
 
+                case 7: { // Search Customer by Phone
+                    char phone[MAX_PHONE_LENGTH];
+                    printf("Enter phone to search: ");
+                    scanf("%19s", phone);
+                    Customer *foundCustomer = searchCustomerByPhone(customers, *numCustomers, phone);
+                    if (foundCustomer) {
+                        displayCustomer(foundCustomer);
+                    } else {
+                        printf("Customer not found.\n");
+                    }
+                    break;
+                }
+
                 case 0: // Back
                     printf("Back to main menu.\n");
                     break;
@@ -208,72 +315,145 @@ void customerManagementMenu(Customer *customers, int *numCustomers, pthread_mute
     }
 
 
+// Ranked bestsellers and top spenders, read straight from the leader boards
+void displaySalesLeaders(void) {
+    TopKEntry leaders[TOPK_CAPACITY];
+
+    int count = getTopK(&topBooks, leaders);
+    printf("\nTop %d Bestsellers:\n", count);
+    for (int i = 0; i < count; i++) {
+        const char *title = "(deleted)";
+        for (int j = 0; j < numBooks; j++) {
+            if (books[j].ISBN == leaders[i].key) {
+                title = books[j].title;
+                break;
+            }
+        }
+        printf("%d. ISBN: %d, Title: %s, Copies Sold: %.0f\n", i + 1, leaders[i].key, title, leaders[i].value);
+    }
+
+    count = getTopK(&topCustomers, leaders);
+    printf("\nTop %d Customers:\n", count);
+    for (int i = 0; i < count; i++) {
+        const char *name = "(deleted)";
+        for (int j = 0; j < numCustomers; j++) {
+            if (customers[j].customerID == leaders[i].key) {
+                name = customers[j].name;
+                break;
+            }
+        }
+        printf("%d. Customer ID: %d, Name: %s, Total Spent: %.2f\n", i + 1, leaders[i].key, name, leaders[i].value);
+    }
+}
+
 // Enhanced Sales Report Function
+// Reads the materialized totals, so it costs O(books + customers) instead of O(sales)
 void displaySalesReport(const Sale *sales, int numSales) {
+    TRACE_SPAN("displaySalesReport");
     if (numSales == 0) {
         printf("No sales records found.\n");
         return;
     }
 
-    printf("\nSales Report:\n");
-
-    float totalRevenue = 0.0;
-    for (int i = 0; i < numSales; i++) {
-        displaySale(&sales[i]);
-        totalRevenue += sales[i].totalPrice;
+    // The totals are maintained by processSale; resync if the history was changed behind our back
+    if (salesStats.numSales != numSales) {
+        recomputeSalesStats(&salesStats, sales, numSales);
+        rebuildSalesLeaders(&salesStats);
     }
 
+    printf("\nSales Report:\n");
+    printf("Total Sales: %d, Copies Sold: %ld, Revenue: %.2f\n",
+           salesStats.numSales, salesStats.unitsSold, salesStats.revenue);
+
     // Additional Analysis
     printf("\nSales by Book:\n");
     for (int i = 0; i < numBooks; i++) {
-        int bookSalesCount = 0;
-        float bookRevenue = 0.0;
-
-        // Iterate through sales to find sales for this book
-        for (int j = 0; j < numSales; j++) {
-            if (sales[j].ISBN == books[i].ISBN) {
-                bookSalesCount += sales[j].quantity;
-                bookRevenue += sales[j].totalPrice;
-            }
-        }
+        const BookTotals *totals = getBookTotals(&salesStats, books[i].ISBN);
 
         // Display if there were sales for this book
-        if (bookSalesCount > 0) {
-            printf("ISBN: %d, Title: %s, Copies Sold: %d, Revenue: %.2f\n",
-                   books[i].ISBN, books[i].title, bookSalesCount, bookRevenue);
+        if (totals && totals->unitsSold > 0) {
+            printf("ISBN: %d, Title: %s, Copies Sold: %d, Revenue: %.2f, Unique Buyers: ~%.0f\n",
+                   books[i].ISBN, books[i].title, totals->unitsSold, totals->revenue, estimateHLL(&totals->buyers));
         }
     }
     printf("\nSales by Customer:\n");
 
     for (int i = 0; i < numCustomers; i++) {
-        int customerSalesCount = 0;
-        float customerRevenue = 0.0;
-
-        // Iterate through sales to find sales for this customer
-        for (int j = 0; j < numSales; j++) {
-            if (sales[j].customerID == customers[i].customerID) {
-                customerSalesCount++;
-                customerRevenue += sales[j].totalPrice;
-            }
-        }
+        const CustomerTotals *totals = getCustomerTotals(&salesStats, customers[i].customerID);
 
         // Display if there were sales for this customer
-        if (customerSalesCount > 0) {
+        if (totals && totals->numPurchases > 0) {
             printf("Customer ID: %d, Name: %s, Number of Purchases: %d, Total Spent: %.2f\n",
-                   customers[i].customerID, customers[i].name, customerSalesCount, customerRevenue);
+                   customers[i].customerID, customers[i].name, totals->numPurchases, totals->totalSpent);
         }
     }
+
+    displaySalesLeaders();
 }
 
+// Time-range report answered from the hourly/daily rollups
+void displayRecentSales(int hours) {
+    time_t now = time(NULL);
+    RollupBucket totals;
+    querySalesRange(&salesRollup, now - (time_t)hours * SECONDS_PER_HOUR, now + 1, &totals);
+
+    printf("\nSales in the last %d hour(s):\n", hours);
+    printf("Number of Sales: %d, Copies Sold: %ld, Revenue: %.2f\n",
+           totals.numSales, totals.unitsSold, totals.revenue);
+    printf("Unique Customers (whole days covered): ~%.0f\n",
+           estimateUniqueCustomers(&salesRollup, now - (time_t)hours * SECONDS_PER_HOUR, now + 1));
+}
+
+// Final snapshot of the totals, so the next start has no sales to replay
+void saveSalesStatsAtExit(void) {
+    PROFILED_LOCK(&bookMutex);
+    saveSalesStats(&salesStats);
+    PROFILED_UNLOCK(&bookMutex);
+}
 
+// Charge the fixed-size stores to their subsystems for the memory report
+void registerStoreMemory(void) {
+    registerStaticMemory(MEM_BOOKS, sizeof(books));
+    registerStaticMemory(MEM_CUSTOMERS, sizeof(customers));
+    registerStaticMemory(MEM_SALES, sizeof(sales));
+    registerStaticMemory(MEM_INDEXES, sizeof(salesStats) + sizeof(salesRollup) + sizeof(topBooks) + sizeof(topCustomers)
+                                     + sizeof(catalogIndex) + sizeof(customerIndex));
+}
+
+int main(int argc, char *argv[]) {
+    // `kill -USR1 <pid>` dumps operation latencies; must start before any other thread
+    startOpLatencySignalDumper();
+    initTracing(); // BOOKSTORE_TRACE=<file> records a Chrome trace, written at exit
+    registerStoreMemory();
 
-int main() {
-    // Load initial data from files with thread safety
-    pthread_mutex_lock(&dataMutex);
+    // Load initial data from files; the loaders take the book and customer locks themselves
     loadBooks(books, &numBooks);
     loadCustomers(customers, &numCustomers);
+    PROFILED_LOCK(&bookMutex); // Sales and their totals
     loadSales(sales, &numSales);
-    pthread_mutex_unlock(&dataMutex);
+    if (!loadSalesStats(&salesStats) || !catchUpSalesStats(&salesStats, sales, numSales)) {
+        recomputeSalesStats(&salesStats, sales, numSales);
+    }
+    checkpointSalesStats(&salesStats);
+    rebuildSalesLeaders(&salesStats);
+    rebuildSalesRollup(&salesRollup, sales, numSales);
+    PROFILED_UNLOCK(&bookMutex);
+
+    // Headless mode: OS2Project --batch <command-file | ->
+    if (argc >= 3 && strcmp(argv[1], "--batch") == 0) {
+        FILE *input = strcmp(argv[2], "-") == 0 ? stdin : fopen(argv[2], "r");
+        if (!input) {
+            perror("Error opening batch file");
+            return 1;
+        }
+        BatchContext context = {books, &numBooks, customers, &numCustomers, sales, &numSales};
+        int failures = runBatch(input, &context);
+        if (input != stdin) {
+            fclose(input);
+        }
+        saveSalesStatsAtExit();
+        return failures == 0 ? 0 : 1;
+    }
 
     int choice;
     do {
@@ -283,6 +463,13 @@ int main() {
         printf("2. Manage Customers (Add, Edit, Delete, Search, List)\n");
         printf("3. Process Sale\n");
         printf("4. View Sales Report\n"); // Enhanced report option
+        printf("5. View All Sales\n");
+        printf("6. View Recent Sales (by hours)\n");
+        printf("7. Export Sales (CSV/JSON)\n");
+        printf("8. Checkout Basket (multiple books)\n");
+        printf("9. Ingest Register Log (bulk sales)\n");
+        printf("10. Latency and Lock Contention Stats\n");
+        printf("11. Memory Usage by Subsystem\n");
         printf("0. Exit\n");
         printf("---------------------------------------\n");
         printf("Your choice: ");
@@ -295,22 +482,131 @@ int main() {
 
         switch (choice) {
             case 1:
-                bookManagementMenu(books, &numBooks, &dataMutex); // Modularize menu
+                bookManagementMenu(books, &numBooks); // Modularize menu
                 break;
             case 2:
-                customerManagementMenu(customers, &numCustomers, &dataMutex);
+                customerManagementMenu(customers, &numCustomers);
                 break;
             case 3:
-                pthread_mutex_lock(&dataMutex); // Lock before sale
-                processSale(books, numBooks, customers, numCustomers, sales, &numSales); // Corrected line
-                pthread_mutex_unlock(&dataMutex); // Unlock after sale
+                processSale(books, numBooks, customers, numCustomers, sales, &numSales); // Takes its own locks after the prompts
                 break;
             case 4:
-                pthread_mutex_lock(&dataMutex); // Lock before display
-                displaySalesReport(sales, numSales); // Implement this function
-                pthread_mutex_unlock(&dataMutex);
+                PROFILED_LOCK(&dataMutex); // Customer names
+                PROFILED_LOCK(&bookMutex); // Sales, their totals and the books, as in processBasket
+                displaySalesReport(sales, numSales);
+                PROFILED_UNLOCK(&bookMutex);
+                PROFILED_UNLOCK(&dataMutex);
+                break;
+            case 5:
+                displayAllSales(sales, &numSales); // Pages under bookMutex, the lock sales are appended under
+                break;
+            case 6: {
+                int hours;
+                printf("Enter number of hours to look back: ");
+                if (scanf("%d", &hours) != 1 || hours <= 0) {
+                    printf("Invalid input. Please enter a positive number.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                PROFILED_LOCK(&bookMutex); // The rollups are updated with the sales
+                displayRecentSales(hours);
+                PROFILED_UNLOCK(&bookMutex);
+                break;
+            }
+            case 7: {
+                int format;
+                char path[256];
+                printf("Format (1 = CSV, 2 = JSON): ");
+                if (scanf("%d", &format) != 1 || (format != 1 && format != 2)) {
+                    printf("Invalid format.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                printf("Output file: ");
+                scanf("%255s", path);
+                PROFILED_LOCK(&bookMutex);
+                long rows = exportSalesToFile(sales, numSales, format == 1 ? REPORT_CSV : REPORT_JSON, path);
+                PROFILED_UNLOCK(&bookMutex);
+                if (rows >= 0) {
+                    printf("Exported %ld sales to %s.\n", rows, path);
+                }
+                break;
+            }
+            case 8: {
+                BasketItem items[MAX_BASKET_ITEMS];
+                int customerID, numItems;
+                printf("Enter customer ID (0 to look up by phone): ");
+                if (scanf("%d", &customerID) != 1) {
+                    printf("Invalid customer ID.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                if (customerID == 0) {
+                    char phone[MAX_PHONE_LENGTH];
+                    printf("Enter phone: ");
+                    scanf("%19s", phone);
+                    customerID = findCustomerByPhone(phone);
+                    if (customerID == 0) {
+                        printf("No customer with phone %s.\n", phone);
+                        break;
+                    }
+                    printf("Customer ID: %d\n", customerID);
+                }
+                printf("Number of items (1-%d): ", MAX_BASKET_ITEMS);
+                if (scanf("%d", &numItems) != 1 || numItems <= 0 || numItems > MAX_BASKET_ITEMS) {
+                    printf("Invalid number of items.\n");
+                    while (getchar() != '\n');
+                    break;
+                }
+                int valid = 1;
+                for (int i = 0; i < numItems && valid; i++) {
+                    printf("Item %d - ISBN and quantity: ", i + 1);
+                    if (scanf("%d %d", &items[i].ISBN, &items[i].quantity) != 2) {
+                        printf("Invalid item.\n");
+                        while (getchar() != '\n');
+                        valid = 0;
+                    }
+                }
+                if (!valid) {
+                    break;
+                }
+                PROFILED_LOCK(&dataMutex);
+                if (processBasket(books, numBooks, customers, numCustomers, sales, &numSales, customerID, items, numItems) > 0) {
+                    float basketTotal = 0.0f;
+                    for (int i = numSales - numItems; i < numSales; i++) {
+                        basketTotal += sales[i].totalPrice;
+                    }
+                    printf("Basket processed successfully! %d item(s), Total: %.2f\n", numItems, basketTotal);
+                }
+                PROFILED_UNLOCK(&dataMutex);
+                break;
+            }
+            case 9: {
+                char path[256];
+                printf("Transaction file: ");
+                scanf("%255s", path);
+                IngestResult *result = memAlloc(MEM_SALES, sizeof(IngestResult));
+                if (!result) {
+                    perror("Memory allocation failed");
+                    break;
+                }
+                PROFILED_LOCK(&dataMutex);
+                if (ingestTransactions(path, books, numBooks, customers, numCustomers, sales, &numSales, result) == 0) {
+                    displayIngestResult(result);
+                }
+                PROFILED_UNLOCK(&dataMutex);
+                memFree(result);
+                break;
+            }
+            case 10:
+                dumpOpLatencies(stdout);
+                dumpLockProfile(stdout);
+                break;
+            case 11:
+                dumpMemoryStats(stdout);
                 break;
             case 0:
+                saveSalesStatsAtExit();
                 printf("Exiting...\n");
                 break;
             default:
@@ -0,0 +1,210 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "lock_profile.h"
+#include "op_latency.h"
+#include "trace.h"
+
+#define MAX_PROFILED_LOCKS 16
+
+// Who holds a profiled lock and since when (written only by the holder)
+typedef struct {
+    const pthread_mutex_t *mutex;
+    LockSite *site;
+    uint64_t acquiredAt;
+} LockHolder;
+
+static LockSite sites[MAX_LOCK_SITES];
+static int numSites;
+static LockHolder holders[MAX_PROFILED_LOCKS];
+static int numHolders;
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER; // Guards site/holder registration only
+
+// Counters are written by the lock holder and read by dumps with relaxed atomics
+static void addCounter(uint64_t *counter, uint64_t delta) {
+    __atomic_store_n(counter, *counter + delta, __ATOMIC_RELAXED);
+}
+
+static void maxCounter(uint64_t *counter, uint64_t value) {
+    if (value > *counter) {
+        __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+    }
+}
+
+static LockHolder *findHolder(const pthread_mutex_t *mutex) {
+    int count = __atomic_load_n(&numHolders, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        if (holders[i].mutex == mutex) {
+            return &holders[i];
+        }
+    }
+    return NULL;
+}
+
+// "&dataMutex" and "dataMutex" (via a pointer parameter) are the same lock
+static const char *lockName(const char *name) {
+    while (*name == '&' || *name == '*') {
+        name++;
+    }
+    return name;
+}
+
+// Slow path, taken once per call site: register the site (and its lock)
+static LockSite *registerSite(pthread_mutex_t *mutex, const char *name, const char *file, int line) {
+    LockSite *site = NULL;
+    pthread_mutex_lock(&registryMutex);
+    for (int i = 0; i < numSites; i++) {
+        if (sites[i].mutex == mutex && sites[i].line == line && strcmp(sites[i].file, file) == 0) {
+            site = &sites[i];
+            break;
+        }
+    }
+    if (!site && numSites < MAX_LOCK_SITES) {
+        site = &sites[numSites];
+        site->mutex = mutex;
+        site->name = name;
+        site->file = file;
+        site->line = line;
+        __atomic_store_n(&numSites, numSites + 1, __ATOMIC_RELEASE);
+    }
+    if (!findHolder(mutex) && numHolders < MAX_PROFILED_LOCKS) {
+        holders[numHolders].mutex = mutex;
+        __atomic_store_n(&numHolders, numHolders + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&registryMutex);
+    return site;
+}
+
+// Lock the mutex, recording whether it was contended and how long we waited.
+// cache is a per-call-site pointer so the fast path skips the registry.
+int profiledLock(pthread_mutex_t *mutex, LockSite **cache, const char *name, const char *file, int line) {
+    uint64_t waited = 0;
+    int contended = 0;
+    int result = pthread_mutex_trylock(mutex);
+    if (result == EBUSY) {
+        contended = 1;
+        uint64_t start = opLatencyNow();
+        result = pthread_mutex_lock(mutex);
+        uint64_t end = opLatencyNow();
+        waited = end - start;
+        traceSpan(lockName(name), "lock wait", start, end);
+    }
+    if (result != 0) {
+        return result;
+    }
+
+    LockSite *site = __atomic_load_n(cache, __ATOMIC_ACQUIRE);
+    if (!site || site->mutex != mutex) {
+        site = registerSite(mutex, name, file, line);
+        __atomic_store_n(cache, site, __ATOMIC_RELEASE);
+    }
+    LockHolder *holder = findHolder(mutex);
+    if (!site || !holder) {
+        return 0; // Tables full: lock still taken, just not profiled
+    }
+
+    addCounter(&site->acquisitions, 1);
+    addCounter(&site->contended, (uint64_t)contended);
+    addCounter(&site->waitNanoseconds, waited);
+    maxCounter(&site->maxWaitNanoseconds, waited);
+    holder->site = site;
+    holder->acquiredAt = opLatencyNow();
+    return 0;
+}
+
+// Unlock the mutex, charging the hold time to the site that acquired it
+int profiledUnlock(pthread_mutex_t *mutex) {
+    LockHolder *holder = findHolder(mutex);
+    if (holder && holder->site) {
+        uint64_t held = opLatencyNow() - holder->acquiredAt;
+        addCounter(&holder->site->holdNanoseconds, held);
+        maxCounter(&holder->site->maxHoldNanoseconds, held);
+        holder->site = NULL;
+    }
+    return pthread_mutex_unlock(mutex);
+}
+
+static int compareByWait(const void *a, const void *b) {
+    const LockSite *siteA = (const LockSite *)a;
+    const LockSite *siteB = (const LockSite *)b;
+    if (siteA->waitNanoseconds != siteB->waitNanoseconds) {
+        return siteA->waitNanoseconds < siteB->waitNanoseconds ? 1 : -1;
+    }
+    return siteA->holdNanoseconds < siteB->holdNanoseconds ? 1 : (siteA->holdNanoseconds > siteB->holdNanoseconds ? -1 : 0);
+}
+
+// CMake passes absolute paths as __FILE__; report them relative to src/,
+// or by file name for code outside it (benchmarks, tools)
+static const char *siteFile(const char *file) {
+    const char *relative = strstr(file, "src/");
+    if (relative) {
+        return relative + 4;
+    }
+    const char *slash = strrchr(file, '/');
+    return slash ? slash + 1 : file;
+}
+
+// Site snapshot with each counter read once
+static void snapshotSite(LockSite *copy, const LockSite *site) {
+    *copy = *site;
+    copy->acquisitions = __atomic_load_n(&site->acquisitions, __ATOMIC_RELAXED);
+    copy->contended = __atomic_load_n(&site->contended, __ATOMIC_RELAXED);
+    copy->waitNanoseconds = __atomic_load_n(&site->waitNanoseconds, __ATOMIC_RELAXED);
+    copy->maxWaitNanoseconds = __atomic_load_n(&site->maxWaitNanoseconds, __ATOMIC_RELAXED);
+    copy->holdNanoseconds = __atomic_load_n(&site->holdNanoseconds, __ATOMIC_RELAXED);
+    copy->maxHoldNanoseconds = __atomic_load_n(&site->maxHoldNanoseconds, __ATOMIC_RELAXED);
+}
+
+// Function to print per-lock totals, then call sites ranked by time spent waiting
+void dumpLockProfile(FILE *out) {
+#ifndef LOCK_PROFILING
+    fprintf(out, "\nLock profiling is disabled (configure with -DLOCK_PROFILING=ON).\n");
+    fflush(out);
+    return;
+#endif
+
+    LockSite snapshot[MAX_LOCK_SITES];
+    int count = __atomic_load_n(&numSites, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        snapshotSite(&snapshot[i], &sites[i]);
+    }
+    qsort(snapshot, count, sizeof(LockSite), compareByWait);
+
+    fprintf(out, "\nLock Contention by Lock:\n");
+    fprintf(out, "%-14s %10s %10s %8s %12s %12s\n", "lock", "acquires", "contended", "cont%", "wait(ms)", "hold(ms)");
+    int numLocks = __atomic_load_n(&numHolders, __ATOMIC_ACQUIRE);
+    for (int lock = 0; lock < numLocks; lock++) {
+        const char *name = NULL;
+        uint64_t acquisitions = 0, contended = 0, wait = 0, hold = 0;
+        for (int i = 0; i < count; i++) {
+            if (snapshot[i].mutex == holders[lock].mutex) {
+                name = lockName(snapshot[i].name);
+                acquisitions += snapshot[i].acquisitions;
+                contended += snapshot[i].contended;
+                wait += snapshot[i].waitNanoseconds;
+                hold += snapshot[i].holdNanoseconds;
+            }
+        }
+        if (name && acquisitions > 0) {
+            fprintf(out, "%-14s %10llu %10llu %7.1f%% %12.3f %12.3f\n", name, (unsigned long long)acquisitions,
+                    (unsigned long long)contended, 100.0 * contended / acquisitions, wait / 1e6, hold / 1e6);
+        }
+    }
+
+    fprintf(out, "\nLock Contention by Call Site (worst first):\n");
+    fprintf(out, "%-14s %-32s %10s %10s %12s %12s %12s %12s\n", "lock", "site", "acquires", "contended",
+            "wait(ms)", "maxwait(us)", "hold(ms)", "maxhold(us)");
+    for (int i = 0; i < count; i++) {
+        const LockSite *site = &snapshot[i];
+        if (site->acquisitions == 0) {
+            continue;
+        }
+        char where[64];
+        snprintf(where, sizeof(where), "%s:%d", siteFile(site->file), site->line);
+        fprintf(out, "%-14s %-32s %10llu %10llu %12.3f %12.1f %12.3f %12.1f\n", lockName(site->name), where,
+                (unsigned long long)site->acquisitions, (unsigned long long)site->contended,
+                site->waitNanoseconds / 1e6, site->maxWaitNanoseconds / 1e3, site->holdNanoseconds / 1e6,
+                site->maxHoldNanoseconds / 1e3);
+    }
+    fflush(out);
+}
@@ -0,0 +1,44 @@
+#ifndef LOCK_PROFILE_H
+#define LOCK_PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define MAX_LOCK_SITES 128 // Distinct (lock, file, line) acquisition sites; power of two
+
+// Contention counters for one acquisition site of one lock. Every field is
+// updated by the thread that holds the lock, so recording needs no atomics.
+typedef struct LockSite {
+    const pthread_mutex_t *mutex;
+    const char *name;
+    const char *file;
+    int line;
+    uint64_t acquisitions;
+    uint64_t contended;       // Acquisitions that found the lock taken
+    uint64_t waitNanoseconds; // Total time blocked waiting for the lock
+    uint64_t maxWaitNanoseconds;
+    uint64_t holdNanoseconds; // Total time the lock was held after this site took it
+    uint64_t maxHoldNanoseconds;
+} LockSite;
+
+// Function prototypes (declarations)
+int profiledLock(pthread_mutex_t *mutex, LockSite **cache, const char *name, const char *file, int line);
+int profiledUnlock(pthread_mutex_t *mutex);
+void dumpLockProfile(FILE *out); // Worst offenders first, by total wait time
+
+// Build with -DLOCK_PROFILING=ON to record contention at every PROFILED_LOCK
+// site; otherwise both macros are the plain pthread calls.
+#ifdef LOCK_PROFILING
+#define PROFILED_LOCK(mutex)                                                    \
+    do {                                                                        \
+        static LockSite *lockSiteCache;                                         \
+        profiledLock((mutex), &lockSiteCache, #mutex, __FILE__, __LINE__);      \
+    } while (0)
+#define PROFILED_UNLOCK(mutex) profiledUnlock(mutex)
+#else
+#define PROFILED_LOCK(mutex) pthread_mutex_lock(mutex)
+#define PROFILED_UNLOCK(mutex) pthread_mutex_unlock(mutex)
+#endif
+
+#endif // LOCK_PROFILE_H
@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mem_account.h"
+
+static const char *tagNames[MEM_TAG_COUNT] = {"books", "customers", "sales", "indexes", "reports", "metrics"};
+
+// Counters per tag, updated with atomics so any thread may allocate
+typedef struct {
+    size_t staticBytes;
+    size_t liveBytes;
+    size_t peakBytes;
+    unsigned long allocations;
+    unsigned long frees;
+} MemCounters;
+
+static MemCounters counters[MEM_TAG_COUNT];
+
+// Prepended to every tracked block; the union keeps the payload maximally aligned
+typedef union {
+    struct {
+        size_t size;
+        MemTag tag;
+    } info;
+    max_align_t align;
+} MemHeader;
+
+static void charge(MemTag tag, size_t size) {
+    MemCounters *c = &counters[tag];
+    size_t live = __atomic_add_fetch(&c->liveBytes, size, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&c->peakBytes, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&c->peakBytes, &peak, live, 1, __ATOMIC_RELAXED,
+                                                        __ATOMIC_RELAXED)) {
+        // peak was reloaded by the failed exchange
+    }
+}
+
+static void release(MemTag tag, size_t size) {
+    __atomic_sub_fetch(&counters[tag].liveBytes, size, __ATOMIC_RELAXED);
+}
+
+void *memAlloc(MemTag tag, size_t size) {
+    MemHeader *header = malloc(sizeof(MemHeader) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->info.size = size;
+    header->info.tag = tag;
+    charge(tag, size);
+    __atomic_add_fetch(&counters[tag].allocations, 1, __ATOMIC_RELAXED);
+    return header + 1;
+}
+
+void *memCalloc(MemTag tag, size_t count, size_t size) {
+    if (size != 0 && count > ((size_t)-1 - sizeof(MemHeader)) / size) {
+        return NULL; // Overflow
+    }
+    void *ptr = memAlloc(tag, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void *memRealloc(void *ptr, size_t size) {
+    if (!ptr) {
+        return NULL; // No tag to charge; callers start from memAlloc
+    }
+    MemHeader *header = (MemHeader *)ptr - 1;
+    MemTag tag = header->info.tag;
+    size_t oldSize = header->info.size;
+    MemHeader *grown = realloc(header, sizeof(MemHeader) + size);
+    if (!grown) {
+        return NULL; // Original block is untouched and still charged
+    }
+    grown->info.size = size;
+    release(tag, oldSize);
+    charge(tag, size);
+    return grown + 1;
+}
+
+void memFree(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    MemHeader *header = (MemHeader *)ptr - 1;
+    release(header->info.tag, header->info.size);
+    __atomic_add_fetch(&counters[header->info.tag].frees, 1, __ATOMIC_RELAXED);
+    free(header);
+}
+
+void registerStaticMemory(MemTag tag, size_t bytes) {
+    __atomic_add_fetch(&counters[tag].staticBytes, bytes, __ATOMIC_RELAXED);
+}
+
+// Function to print fixed, live and peak bytes and allocation counts per subsystem
+void dumpMemoryStats(FILE *out) {
+    fprintf(out, "\nMemory by Subsystem (bytes):\n");
+    fprintf(out, "%-10s %12s %12s %12s %12s %10s %10s\n", "subsystem", "static", "heap live", "heap peak",
+            "total", "allocs", "frees");
+
+    size_t totalStatic = 0, totalLive = 0, totalPeak = 0;
+    unsigned long totalAllocations = 0, totalFrees = 0;
+    for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        size_t staticBytes = __atomic_load_n(&counters[tag].staticBytes, __ATOMIC_RELAXED);
+        size_t live = __atomic_load_n(&counters[tag].liveBytes, __ATOMIC_RELAXED);
+        size_t peak = __atomic_load_n(&counters[tag].peakBytes, __ATOMIC_RELAXED);
+        unsigned long allocations = __atomic_load_n(&counters[tag].allocations, __ATOMIC_RELAXED);
+        unsigned long frees = __atomic_load_n(&counters[tag].frees, __ATOMIC_RELAXED);
+        fprintf(out, "%-10s %12zu %12zu %12zu %12zu %10lu %10lu\n", tagNames[tag], staticBytes, live, peak,
+                staticBytes + live, allocations, frees);
+        totalStatic += staticBytes;
+        totalLive += live;
+        totalPeak += peak; // Sum of per-subsystem peaks (an upper bound on the overall peak)
+        totalAllocations += allocations;
+        totalFrees += frees;
+    }
+    fprintf(out, "%-10s %12zu %12zu %12zu %12zu %10lu %10lu\n", "total", totalStatic, totalLive, totalPeak,
+            totalStatic + totalLive, totalAllocations, totalFrees);
+    fflush(out);
+}
@@ -0,0 +1,29 @@
+#ifndef MEM_ACCOUNT_H
+#define MEM_ACCOUNT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Subsystems that memory is charged to
+typedef enum {
+    MEM_BOOKS,
+    MEM_CUSTOMERS,
+    MEM_SALES,
+    MEM_INDEXES, // Lookup structures and materialized aggregates
+    MEM_REPORTS,
+    MEM_METRICS, // Per-thread latency histograms and trace buffers
+    MEM_TAG_COUNT
+} MemTag;
+
+// Function prototypes (declarations)
+// Tracked allocations carry a small header recording their size and tag, so
+// they must be released with memFree (never plain free) and vice versa.
+void *memAlloc(MemTag tag, size_t size);
+void *memCalloc(MemTag tag, size_t count, size_t size);
+void *memRealloc(void *ptr, size_t size); // Keeps the tag ptr was allocated with
+void memFree(void *ptr);
+
+void registerStaticMemory(MemTag tag, size_t bytes); // Fixed arrays sized at compile time
+void dumpMemoryStats(FILE *out);
+
+#endif // MEM_ACCOUNT_H
@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include "op_latency.h"
+#include "trace.h"
+#include "mem_account.h"
+
+static const char *opNames[OP_COUNT] = {
+    "loadBooks", "saveBooks", "insertBook", "editBook", "deleteBook", "searchBookByISBN",
+    "searchBookByTitle", "importCatalog", "bulkAdjust", "loadCustomers", "saveCustomers", "insertCustomer",
+    "editCustomer", "deleteCustomer", "searchCustomerByID", "searchCustomerByName", "searchCustomerByPhone", "loadSales", "saveSales",
+    "appendSales", "processSale", "processBasket", "ingestTransactions", "exportReport"
+};
+
+// Per-thread histograms; only the owning thread writes, dumps read with relaxed atomics
+typedef struct ThreadHistograms {
+    uint64_t counts[OP_COUNT][LATENCY_BUCKETS];
+    uint64_t totalNanoseconds[OP_COUNT];
+    uint64_t maxNanoseconds[OP_COUNT];
+    struct ThreadHistograms *next;
+} ThreadHistograms;
+
+static __thread ThreadHistograms *localHistograms;
+static ThreadHistograms *allHistograms; // Registry of every thread's histograms (kept after thread exit)
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+uint64_t opLatencyNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bucketFor(uint64_t nanoseconds) {
+    if (nanoseconds < (1u << LATENCY_SUB_BITS)) {
+        return (int)nanoseconds; // Exact for tiny values
+    }
+    int magnitude = 63 - __builtin_clzll(nanoseconds); // >= LATENCY_SUB_BITS
+    int shift = magnitude - LATENCY_SUB_BITS;
+    int bucket = ((shift + 1) << LATENCY_SUB_BITS) + (int)((nanoseconds >> shift) & ((1u << LATENCY_SUB_BITS) - 1));
+    return bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1;
+}
+
+// Upper bound of the values that land in a bucket
+static uint64_t bucketValue(int bucket) {
+    if (bucket < (1 << LATENCY_SUB_BITS)) {
+        return (uint64_t)bucket;
+    }
+    int shift = (bucket >> LATENCY_SUB_BITS) - 1;
+    uint64_t sub = (uint64_t)(bucket & ((1 << LATENCY_SUB_BITS) - 1));
+    return (((1ull << LATENCY_SUB_BITS) + sub + 1) << shift) - 1;
+}
+
+static ThreadHistograms *threadHistograms(void) {
+    if (!localHistograms) {
+        ThreadHistograms *histograms = memCalloc(MEM_METRICS, 1, sizeof(ThreadHistograms));
+        if (!histograms) {
+            return NULL;
+        }
+        pthread_mutex_lock(&registryMutex);
+        histograms->next = allHistograms;
+        allHistograms = histograms;
+        pthread_mutex_unlock(&registryMutex);
+        localHistograms = histograms;
+    }
+    return localHistograms;
+}
+
+void recordOpLatency(OpId op, uint64_t nanoseconds) {
+    ThreadHistograms *histograms = threadHistograms();
+    if (!histograms) {
+        return;
+    }
+    uint64_t *count = &histograms->counts[op][bucketFor(nanoseconds)];
+    __atomic_store_n(count, *count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&histograms->totalNanoseconds[op], histograms->totalNanoseconds[op] + nanoseconds,
+                     __ATOMIC_RELAXED);
+    if (nanoseconds > histograms->maxNanoseconds[op]) {
+        __atomic_store_n(&histograms->maxNanoseconds[op], nanoseconds, __ATOMIC_RELAXED);
+    }
+}
+
+void endOpLatencyScope(OpLatencyScope *scope) {
+    uint64_t end = opLatencyNow();
+    recordOpLatency(scope->op, end - scope->start);
+    traceSpan(opNames[scope->op], "op", scope->start, end);
+}
+
+// Bucket upper bounds can overshoot the largest sample, so cap at the observed max
+static uint64_t percentileOf(const uint64_t *counts, uint64_t total, uint64_t max, double fraction) {
+    uint64_t target = (uint64_t)(fraction * total + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        seen += counts[bucket];
+        if (seen >= target) {
+            uint64_t value = bucketValue(bucket);
+            return value < max ? value : max;
+        }
+    }
+    return max;
+}
+
+// Function to print counts and percentiles per operation (times in microseconds)
+void dumpOpLatencies(FILE *out) {
+    uint64_t *counts = memAlloc(MEM_METRICS, LATENCY_BUCKETS * sizeof(uint64_t));
+    if (!counts) {
+        return;
+    }
+
+    fprintf(out, "\nOperation Latency (us):\n");
+    fprintf(out, "%-22s %10s %10s %10s %10s %10s %10s %10s\n",
+            "operation", "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+
+    pthread_mutex_lock(&registryMutex);
+    for (int op = 0; op < OP_COUNT; op++) {
+        memset(counts, 0, LATENCY_BUCKETS * sizeof(uint64_t));
+        uint64_t total = 0, sum = 0, max = 0;
+        for (ThreadHistograms *h = allHistograms; h; h = h->next) {
+            for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+                uint64_t count = __atomic_load_n(&h->counts[op][bucket], __ATOMIC_RELAXED);
+                counts[bucket] += count;
+                total += count;
+            }
+            sum += __atomic_load_n(&h->totalNanoseconds[op], __ATOMIC_RELAXED);
+            uint64_t threadMax = __atomic_load_n(&h->maxNanoseconds[op], __ATOMIC_RELAXED);
+            if (threadMax > max) {
+                max = threadMax;
+            }
+        }
+        if (total == 0) {
+            continue;
+        }
+        fprintf(out, "%-22s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", opNames[op],
+                (unsigned long long)total, sum / 1e3 / total,
+                percentileOf(counts, total, max, 0.50) / 1e3, percentileOf(counts, total, max, 0.90) / 1e3,
+                percentileOf(counts, total, max, 0.99) / 1e3, percentileOf(counts, total, max, 0.999) / 1e3,
+                max / 1e3);
+    }
+    pthread_mutex_unlock(&registryMutex);
+
+    fflush(out);
+    memFree(counts);
+}
+
+static void *signalDumper(void *arg) {
+    sigset_t *signals = (sigset_t *)arg;
+    for (;;) {
+        int signal;
+        if (sigwait(signals, &signal) == 0) {
+            dumpOpLatencies(stderr);
+        }
+    }
+    return NULL;
+}
+
+// Block SIGUSR1 here (inherited by threads created later) and let a dedicated
+// thread dump the stats whenever it arrives: `kill -USR1 <pid>`
+int startOpLatencySignalDumper(void) {
+    static sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+        return -1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, signalDumper, &signals) != 0) {
+        perror("Error starting stats dump thread");
+        return -1;
+    }
+    pthread_detach(thread);
+    return 0;
+}
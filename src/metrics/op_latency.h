@@ -0,0 +1,60 @@
+#ifndef OP_LATENCY_H
+#define OP_LATENCY_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Public operations with latency tracking
+typedef enum {
+    OP_LOAD_BOOKS,
+    OP_SAVE_BOOKS,
+    OP_INSERT_BOOK,
+    OP_EDIT_BOOK,
+    OP_DELETE_BOOK,
+    OP_SEARCH_BOOK_ISBN,
+    OP_SEARCH_BOOK_TITLE,
+    OP_IMPORT_CATALOG,
+    OP_BULK_ADJUST,
+    OP_LOAD_CUSTOMERS,
+    OP_SAVE_CUSTOMERS,
+    OP_INSERT_CUSTOMER,
+    OP_EDIT_CUSTOMER,
+    OP_DELETE_CUSTOMER,
+    OP_SEARCH_CUSTOMER_ID,
+    OP_SEARCH_CUSTOMER_NAME,
+    OP_SEARCH_CUSTOMER_PHONE,
+    OP_LOAD_SALES,
+    OP_SAVE_SALES,
+    OP_APPEND_SALES,
+    OP_PROCESS_SALE,
+    OP_PROCESS_BASKET,
+    OP_INGEST_TRANSACTIONS,
+    OP_EXPORT_REPORT,
+    OP_COUNT
+} OpId;
+
+// Log-linear (HDR-style) buckets: 16 sub-buckets per power of two of
+// nanoseconds, so each bucket is within ~6% of its values, up to ~4.9 hours.
+#define LATENCY_SUB_BITS 4
+#define LATENCY_MAGNITUDES 41
+#define LATENCY_BUCKETS (LATENCY_MAGNITUDES << LATENCY_SUB_BITS)
+
+// Function prototypes (declarations)
+uint64_t opLatencyNow(void); // Monotonic nanoseconds
+void recordOpLatency(OpId op, uint64_t nanoseconds);
+void dumpOpLatencies(FILE *out);
+int startOpLatencySignalDumper(void); // Dumps to stderr on SIGUSR1; call before creating other threads
+
+// Scope guard used by OP_LATENCY_SCOPE: records on every return path
+typedef struct {
+    OpId op;
+    uint64_t start;
+} OpLatencyScope;
+
+void endOpLatencyScope(OpLatencyScope *scope);
+
+// Times the rest of the enclosing block as one call of op
+#define OP_LATENCY_SCOPE(op) \
+    OpLatencyScope opLatencyScope __attribute__((cleanup(endOpLatencyScope))) = {(op), opLatencyNow()}
+
+#endif // OP_LATENCY_H
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "trace.h"
+#include "mem_account.h"
+
+typedef struct {
+    const char *name;
+    const char *category;
+    uint64_t start;
+    uint64_t end;
+} TraceEvent;
+
+// Per-thread span buffer; only the owning thread appends, the flush reads up to count
+typedef struct ThreadTrace {
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+    int count;
+    long dropped;
+    int threadNumber;
+    struct ThreadTrace *next;
+} ThreadTrace;
+
+int traceEnabled = 0;
+static const char *tracePath;
+static uint64_t traceOrigin; // Timestamps are written relative to tracing start
+static __thread ThreadTrace *localTrace;
+static ThreadTrace *allTraces;
+static int numTraceThreads;
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Function to turn tracing on when BOOKSTORE_TRACE names an output file
+void initTracing(void) {
+    tracePath = getenv(TRACE_ENV_VAR);
+    if (!tracePath || tracePath[0] == '\0' || traceEnabled) {
+        return;
+    }
+    traceOrigin = opLatencyNow();
+    traceEnabled = 1;
+    atexit(flushTrace);
+}
+
+static ThreadTrace *threadTrace(void) {
+    if (!localTrace) {
+        ThreadTrace *trace = memCalloc(MEM_METRICS, 1, sizeof(ThreadTrace));
+        if (!trace) {
+            return NULL;
+        }
+        pthread_mutex_lock(&registryMutex);
+        trace->threadNumber = ++numTraceThreads;
+        trace->next = allTraces;
+        allTraces = trace;
+        pthread_mutex_unlock(&registryMutex);
+        localTrace = trace;
+    }
+    return localTrace;
+}
+
+void traceSpan(const char *name, const char *category, uint64_t start, uint64_t end) {
+    if (!traceEnabled) {
+        return;
+    }
+    ThreadTrace *trace = threadTrace();
+    if (!trace) {
+        return;
+    }
+    if (trace->count == TRACE_EVENTS_PER_THREAD) {
+        trace->dropped++;
+        return;
+    }
+    TraceEvent *event = &trace->events[trace->count];
+    event->name = name;
+    event->category = category;
+    event->start = start;
+    event->end = end;
+    __atomic_store_n(&trace->count, trace->count + 1, __ATOMIC_RELEASE);
+}
+
+void endTraceScope(TraceScope *scope) {
+    if (traceEnabled) {
+        traceSpan(scope->name, "phase", scope->start, opLatencyNow());
+    }
+}
+
+// Function to write every thread's spans as complete ("X") events, in microseconds
+void flushTrace(void) {
+    if (!traceEnabled) {
+        return;
+    }
+    FILE *file = fopen(tracePath, "w");
+    if (!file) {
+        perror("Error opening trace file for writing");
+        return;
+    }
+
+    long written = 0, dropped = 0;
+    int pid = (int)getpid();
+    fprintf(file, "{\"traceEvents\":[");
+    pthread_mutex_lock(&registryMutex);
+    for (ThreadTrace *trace = allTraces; trace; trace = trace->next) {
+        int count = __atomic_load_n(&trace->count, __ATOMIC_ACQUIRE);
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                written++ ? "," : "", pid, trace->threadNumber, trace->threadNumber);
+        for (int i = 0; i < count; i++) {
+            const TraceEvent *event = &trace->events[i];
+            uint64_t start = event->start > traceOrigin ? event->start - traceOrigin : 0;
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    event->name, event->category, start / 1e3, (event->end - event->start) / 1e3, pid,
+                    trace->threadNumber);
+            written++;
+        }
+        dropped += trace->dropped;
+    }
+    pthread_mutex_unlock(&registryMutex);
+    fprintf(file, "\n]}\n");
+
+    if (ferror(file)) {
+        perror("Error writing trace file");
+    }
+    fclose(file);
+    if (dropped > 0) {
+        fprintf(stderr, "Warning: Trace buffers were full, %ld spans dropped.\n", dropped);
+    }
+}
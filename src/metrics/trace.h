@@ -0,0 +1,33 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "op_latency.h"
+
+#define TRACE_ENV_VAR "BOOKSTORE_TRACE"    // Set to an output path to record a trace
+#define TRACE_EVENTS_PER_THREAD 65536      // Later spans on a full buffer are dropped
+
+extern int traceEnabled;
+
+// Function prototypes (declarations)
+void initTracing(void); // Reads TRACE_ENV_VAR; call once at startup
+void traceSpan(const char *name, const char *category, uint64_t start, uint64_t end);
+void flushTrace(void);  // Writes Chrome trace-event JSON (also run at exit)
+
+// Scope guard used by TRACE_SPAN: records a span on every return path
+typedef struct {
+    const char *name;
+    uint64_t start;
+} TraceScope;
+
+void endTraceScope(TraceScope *scope);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Records the rest of the enclosing block as one span (one branch when tracing is off)
+#define TRACE_SPAN(name)                                                                       \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__) __attribute__((cleanup(endTraceScope))) = { \
+        (name), traceEnabled ? opLatencyNow() : 0}
+
+#endif // TRACE_H
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "render.h"
+
+#define RECORD_SEPARATOR "--------------------\n"
+
+int beginStdoutRender(ReportWriter *out) {
+    fflush(stdout);
+    return openReportWriter(out, STDOUT_FILENO);
+}
+
+void endStdoutRender(ReportWriter *out) {
+    closeReportWriter(out);
+}
+
+// Label, value and newline without a printf call
+static void writeField(ReportWriter *out, const char *label, const char *value) {
+    reportWriteString(out, label);
+    reportWriteString(out, value);
+    reportWrite(out, "\n", 1);
+}
+
+static void writeIntField(ReportWriter *out, const char *label, long long value) {
+    reportWriteString(out, label);
+    reportWriteInt(out, value);
+    reportWrite(out, "\n", 1);
+}
+
+static void writePriceField(ReportWriter *out, const char *label, double value) {
+    reportWriteString(out, label);
+    reportWritePrice(out, value);
+    reportWrite(out, "\n", 1);
+}
+
+void renderBook(ReportWriter *out, const Book *book) {
+    writeIntField(out, "ISBN: ", book->ISBN);
+    writeField(out, "Title: ", book->title);
+    writeField(out, "Author: ", book->author);
+    writePriceField(out, "Price: ", book->price);
+    writeIntField(out, "Quantity: ", book->quantity);
+    reportWriteString(out, RECORD_SEPARATOR);
+}
+
+void renderCustomer(ReportWriter *out, const Customer *customer) {
+    writeIntField(out, "Customer ID: ", customer->customerID);
+    writeField(out, "Name: ", customer->name);
+    writeField(out, "Phone: ", customer->phone);
+    reportWriteString(out, RECORD_SEPARATOR);
+}
+
+// Local time of the last hour looked up; sales sorted by time mostly hit it,
+// so localtime_r runs about once per hour of history instead of once per row.
+// (Zone offset changes happen on hour boundaries.)
+static __thread time_t cachedHourStart = -1;
+static __thread char cachedHour[16]; // "YYYY-MM-DD HH:"
+
+static void writeDate(ReportWriter *out, time_t timestamp) {
+    if (cachedHourStart < 0 || timestamp < cachedHourStart || timestamp >= cachedHourStart + 3600) {
+        struct tm local;
+        if (!localtime_r(&timestamp, &local)) {
+            reportWriteInt(out, (long long)timestamp);
+            return;
+        }
+        strftime(cachedHour, sizeof(cachedHour), "%Y-%m-%d %H:", &local);
+        cachedHourStart = timestamp - (local.tm_min * 60 + local.tm_sec);
+    }
+
+    int seconds = (int)(timestamp - cachedHourStart);
+    char minuteSecond[5] = {(char)('0' + seconds / 600), (char)('0' + seconds / 60 % 10), ':',
+                            (char)('0' + seconds % 60 / 10), (char)('0' + seconds % 10)};
+    reportWriteString(out, cachedHour);
+    reportWrite(out, minuteSecond, sizeof(minuteSecond));
+}
+
+void renderSale(ReportWriter *out, const Sale *sale) {
+    writeIntField(out, "Sale ID: ", sale->saleID);
+    writeIntField(out, "Customer ID: ", sale->customerID);
+    writeIntField(out, "ISBN: ", sale->ISBN);
+    writeIntField(out, "Quantity: ", sale->quantity);
+    writePriceField(out, "Total Price: ", sale->totalPrice);
+    if (sale->timestamp > 0) {
+        reportWriteString(out, "Date: ");
+        writeDate(out, sale->timestamp);
+        reportWrite(out, "\n", 1);
+    }
+    reportWriteString(out, RECORD_SEPARATOR);
+}
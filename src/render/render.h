@@ -0,0 +1,22 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "../book/book.h"
+#include "../customer/customer.h"
+#include "../sales/sales.h"
+#include "../sales/sales_report.h"
+
+// Records fetched per listing page; each page is copied out under the lock
+// and formatted and written after it is released.
+#define RENDER_PAGE_ROWS 512
+
+// Function prototypes (declarations)
+// Console rendering into a ReportWriter, with the same layout the old
+// printf-based display functions used.
+int beginStdoutRender(ReportWriter *out); // Flushes stdio first so output stays in order
+void endStdoutRender(ReportWriter *out);
+void renderBook(ReportWriter *out, const Book *book);
+void renderCustomer(ReportWriter *out, const Customer *customer);
+void renderSale(ReportWriter *out, const Sale *sale);
+
+#endif // RENDER_H
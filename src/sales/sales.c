@@ -2,9 +2,22 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "sales.h"
+#include "sales_stats.h"
+#include "sales_rollup.h"
+#include "sales_topk.h"
 #include "../book/book.h"
 #include "../customer/customer.h"
+#include "../book/book_index.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/trace.h"
+#include "../metrics/mem_account.h"
+#include "../render/render.h"
+#include "../listing/listing.h"
 
 #define BOOKS_DATA_FILE "data/books.csv"
 #define CUSTOMERS_DATA_FILE "data/customers.csv"
@@ -13,6 +26,12 @@
 
 // Function to load sales data from file
 void loadSales(Sale *sales, int *numSales) {
+    loadSalesInto(sales, numSales, MAX_SALES);
+}
+
+// Function to load sales data into an array holding at most capacity sales
+void loadSalesInto(Sale *sales, int *numSales, int capacity) {
+    OP_LATENCY_SCOPE(OP_LOAD_SALES);
     FILE *file = fopen(SALES_DATA_FILE, "r");
     if (!file) {
         *numSales = 0;
@@ -20,8 +39,21 @@ void loadSales(Sale *sales, int *numSales) {
     }
 
     *numSales = 0;
-    while (fscanf(file, "%d %d %d %d %f", &sales[*numSales].saleID, &sales[*numSales].customerID,
-                  &sales[*numSales].ISBN, &sales[*numSales].quantity, &sales[*numSales].totalPrice) == 5) {
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (*numSales >= capacity) {
+            fprintf(stderr, "Error: Maximum number of sales reached.\n");
+            break;
+        }
+        Sale *sale = &sales[*numSales];
+        long timestamp = 0;
+        // Older files have no timestamp column
+        int fields = sscanf(line, "%d %d %d %d %f %ld", &sale->saleID, &sale->customerID,
+                            &sale->ISBN, &sale->quantity, &sale->totalPrice, &timestamp);
+        if (fields < 5) {
+            break;
+        }
+        sale->timestamp = (time_t)timestamp;
         (*numSales)++;
     }
     fclose(file);
@@ -29,6 +61,7 @@ void loadSales(Sale *sales, int *numSales) {
 
 // Function to save sales data to file
 void saveSales(const Sale *sales, int numSales) {
+    OP_LATENCY_SCOPE(OP_SAVE_SALES);
     FILE *file = fopen(SALES_DATA_FILE, "w");
     if (!file) {
         perror("Error opening file for writing");
@@ -36,53 +69,193 @@ void saveSales(const Sale *sales, int numSales) {
     }
 
     for (int i = 0; i < numSales; i++) {
-        fprintf(file, "%d %d %d %d %.2f\n", sales[i].saleID, sales[i].customerID,
-                sales[i].ISBN, sales[i].quantity, sales[i].totalPrice);
+        fprintf(file, "%d %d %d %d %.2f %ld\n", sales[i].saleID, sales[i].customerID,
+                sales[i].ISBN, sales[i].quantity, sales[i].totalPrice, (long)sales[i].timestamp);
     }
     fclose(file);
 }
 
-// Function to process a sale
-void processSale(const Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales) {
-    Sale newSale;
+// Function to append sales to the data file with a single write
+void appendSales(const Sale *sales, int count) {
+    OP_LATENCY_SCOPE(OP_APPEND_SALES);
+    // Worst case per record: five ints, a price and a timestamp, each well under 24 chars
+    size_t capacity = (size_t)count * 160;
+    char *buffer = memAlloc(MEM_SALES, capacity);
+    if (!buffer) {
+        perror("Memory allocation failed");
+        return;
+    }
+
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        used += snprintf(buffer + used, capacity - used, "%d %d %d %d %.2f %ld\n", sales[i].saleID,
+                         sales[i].customerID, sales[i].ISBN, sales[i].quantity, sales[i].totalPrice,
+                         (long)sales[i].timestamp);
+    }
+
+    int fd = open(SALES_DATA_FILE, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        perror("Error opening sales file for appending");
+        memFree(buffer);
+        return;
+    }
+    if (write(fd, buffer, used) != (ssize_t)used) {
+        perror("Error appending to sales file");
+    }
+    close(fd);
+    memFree(buffer);
+}
+
+// Fold a stored sale into the materialized totals and time rollups
+void trackSale(const Sale *sale) {
+    TRACE_SPAN("trackSale");
+    recordSaleStats(&salesStats, sale);
+    updateSalesLeaders(&salesStats, sale);
+    recordSaleRollup(&salesRollup, sale);
+}
+
+// Function to process a sale: reads the customer, ISBN and quantity, then
+// records it as a one-line basket so stock, IDs and totals follow one path
+void processSale(Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales) {
+    int customerID;
+    BasketItem item;
+
+    printf("Enter customer ID: ");
+    if (scanf("%d", &customerID) != 1) {
+        fprintf(stderr, "Error: Invalid customer ID input.\n");
+        while (getchar() != '\n');
+        return;
+    }
+    printf("Enter ISBN and quantity: ");
+    if (scanf("%d %d", &item.ISBN, &item.quantity) != 2) {
+        fprintf(stderr, "Error: Invalid ISBN or quantity input.\n");
+        while (getchar() != '\n');
+        return;
+    }
+
+    // Timed from here so the prompts' think time stays out of the histogram;
+    // rejected sales leave the history and the materialized totals untouched
+    OP_LATENCY_SCOPE(OP_PROCESS_SALE);
+    PROFILED_LOCK(&dataMutex); // Customers stay put while processBasket looks the buyer up
+    if (processBasket(books, numBooks, customers, numCustomers, sales, numSales, customerID, &item, 1) > 0) {
+        printf("Sale processed successfully! Total: %.2f\n", sales[*numSales - 1].totalPrice);
+    }
+    PROFILED_UNLOCK(&dataMutex);
+}
+
+// Function to check out a multi-item basket as one transaction.
+// Stock for every line is validated before anything changes, then stock is
+// decremented, sale IDs assigned and the records appended under one hold of
+// bookMutex with one journal write. Returns the number of sales recorded, or
+// -1 if the basket was rejected (in which case nothing was changed).
+int processBasket(Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales,
+                  int customerID, const BasketItem *items, int numItems) {
+    OP_LATENCY_SCOPE(OP_PROCESS_BASKET);
+    if (numItems <= 0 || numItems > MAX_BASKET_ITEMS) {
+        fprintf(stderr, "Error: A basket must hold between 1 and %d items.\n", MAX_BASKET_ITEMS);
+        return -1;
+    }
+
+    int customerFound = 0;
+    for (int i = 0; i < numCustomers; i++) {
+        if (customers[i].customerID == customerID) {
+            customerFound = 1;
+            break;
+        }
+    }
+    if (!customerFound) {
+        fprintf(stderr, "Error: Customer with ID %d not found.\n", customerID);
+        return -1;
+    }
+
+    PROFILED_LOCK(&bookMutex);
 
-    // Input and Validation (customer ID, ISBN, quantity, etc.)
-    // (Same as provided in previous responses)
-    // ...
+    if (*numSales + numItems > MAX_SALES) {
+        fprintf(stderr, "Error: Maximum number of sales reached.\n");
+        PROFILED_UNLOCK(&bookMutex);
+        return -1;
+    }
 
-    // Generate Sale ID (assuming IDs are simply sequential)
-    time_t t;
-    srand((unsigned) time(&t)); // Seed random number generator
-    newSale.saleID = rand(); // Generate a random sale ID
-    newSale.saleID = (*numSales > 0) ? sales[*numSales - 1].saleID + 1 : 1;
+    // Validate every line first; repeated ISBNs draw on the same stock
+    int bookIndex[MAX_BASKET_ITEMS];
+    for (int i = 0; i < numItems; i++) {
+        bookIndex[i] = findBookIndex(books, numBooks, items[i].ISBN);
+        if (bookIndex[i] < 0 || items[i].quantity <= 0) {
+            fprintf(stderr, "Error: Invalid basket line %d (ISBN %d, quantity %d).\n",
+                    i + 1, items[i].ISBN, items[i].quantity);
+            PROFILED_UNLOCK(&bookMutex);
+            return -1;
+        }
 
-    // Store the sale:
-    sales[*numSales] = newSale;
-    (*numSales)++;
-    saveSales(sales, *numSales);
+        int requested = 0;
+        for (int j = 0; j <= i; j++) {
+            if (items[j].ISBN == items[i].ISBN) {
+                requested += items[j].quantity;
+            }
+        }
+        if (requested > books[bookIndex[i]].quantity) {
+            fprintf(stderr, "Error: Not enough stock for ISBN %d (requested %d, available %d).\n",
+                    items[i].ISBN, requested, books[bookIndex[i]].quantity);
+            PROFILED_UNLOCK(&bookMutex);
+            return -1;
+        }
+    }
 
-    printf("Sale processed successfully! Total: %.2f\n", newSale.totalPrice);
+    // Commit: decrement stock, assign IDs, append the records
+    Sale *newSales = &sales[*numSales];
+    int nextID = (*numSales > 0) ? sales[*numSales - 1].saleID + 1 : 1;
+    time_t now = time(NULL);
+    for (int i = 0; i < numItems; i++) {
+        Book *book = &books[bookIndex[i]];
+        Book before = *book;
+        book->quantity -= items[i].quantity;
+        indexUpdateBook(&before, book);
+
+        newSales[i].saleID = nextID + i;
+        newSales[i].customerID = customerID;
+        newSales[i].ISBN = items[i].ISBN;
+        newSales[i].quantity = items[i].quantity;
+        newSales[i].totalPrice = book->price * items[i].quantity;
+        newSales[i].timestamp = now;
+        trackSale(&newSales[i]);
+    }
+    *numSales += numItems;
+
+    appendSales(newSales, numItems);
+    saveBooks(books, numBooks);
+    checkpointSalesStats(&salesStats);
+
+    PROFILED_UNLOCK(&bookMutex);
+    return numItems;
 }
 
 // Function to display a single sale
 void displaySale(const Sale *sale) {
-    printf("Sale ID: %d\n", sale->saleID);
-    printf("Customer ID: %d\n", sale->customerID);
-    printf("ISBN: %d\n", sale->ISBN);
-    printf("Quantity: %d\n", sale->quantity);
-    printf("Total Price: %.2f\n", sale->totalPrice);
-    printf("--------------------\n");
+    ReportWriter out;
+    if (beginStdoutRender(&out) == 0) {
+        renderSale(&out, sale);
+        endStdoutRender(&out);
+    }
 }
 
-// Function to display all sales
-void displayAllSales(const Sale *sales, int numSales) {
-    if (numSales == 0) {
-        printf("No sales records found.\n");
+// Function to display all sales, paging through them under bookMutex like the catalog
+void displayAllSales(const Sale *sales, const int *numSales) {
+    ReportWriter out;
+    Sale *page = memAlloc(MEM_REPORTS, RENDER_PAGE_ROWS * sizeof(Sale));
+    if (!page || beginStdoutRender(&out) != 0) {
+        memFree(page);
         return;
     }
 
-    printf("All Sales:\n");
-    for (int i = 0; i < numSales; i++) {
-        displaySale(&sales[i]);
+    ListCursor cursor;
+    initListCursor(&cursor, RENDER_PAGE_ROWS, 0);
+    int count = listSalesPage(sales, numSales, &cursor, page);
+    reportWriteString(&out, count == 0 ? "No sales records found.\n" : "All Sales:\n");
+    for (; count > 0; count = listSalesPage(sales, numSales, &cursor, page)) {
+        for (int i = 0; i < count; i++) {
+            renderSale(&out, &page[i]);
+        }
     }
+    endStdoutRender(&out);
+    memFree(page);
 }
@@ -1,9 +1,14 @@
 #ifndef SALES_H
 #define SALES_H
 
+#include <time.h>
+
 #include "../book/book.h"
 #include "../customer/customer.h"
 
+#define MAX_SALES 100
+#define MAX_BASKET_ITEMS 32
+
 // Structure to represent a sale
 typedef struct {
     int saleID;
@@ -11,15 +16,27 @@ typedef struct {
     int ISBN;
     int quantity;
     float totalPrice;
-    // You can add a timestamp (date and time) here if needed
+    time_t timestamp; // When the sale was processed (0 for sales recorded before timestamps)
 } Sale;
 
+// One line of a multi-item checkout
+typedef struct {
+    int ISBN;
+    int quantity;
+} BasketItem;
+
 // Function prototypes (declarations)
-void processSale(const Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales);
+void processSale(Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales);
 void displaySale(const Sale *sale);
-void displayAllSales(const Sale *sales, int numSales);
+void displayAllSales(const Sale *sales, const int *numSales); // Count read under bookMutex
 void loadSales(Sale *sales, int *numSales);
+// Same, into a caller-sized array; stops with an error once capacity rows are read
+void loadSalesInto(Sale *sales, int *numSales, int capacity);
 void saveSales(const Sale *sales, int numSales);
+void appendSales(const Sale *sales, int count);
+void trackSale(const Sale *sale); // Update aggregates for a stored sale (caller checkpoints the stats snapshot)
+int processBasket(Book *books, int numBooks, const Customer *customers, int numCustomers, Sale *sales, int *numSales,
+                  int customerID, const BasketItem *items, int numItems);
 
 // Add more function prototypes for sales reports, calculations, etc. as needed
 
@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "sales_aggregate.h"
+#include "../metrics/trace.h"
+#include "../metrics/mem_account.h"
+
+// Work assigned to one aggregation worker
+typedef struct {
+    const Sale *sales;
+    int begin;
+    int end;
+    SalesAggregate partial; // Owned by this worker only, no shared writes
+    int failed;             // The partial could not grow
+} AggregateTask;
+
+// Multiplicative hash of a positive key into a table of the given power-of-two size
+static unsigned int aggregateSlot(int key, int capacity) {
+    return ((unsigned int)key * 2654435761u) & (unsigned int)(capacity - 1);
+}
+
+static int initSalesAggregate(SalesAggregate *aggregate) {
+    memset(aggregate, 0, sizeof(*aggregate));
+    aggregate->books = memCalloc(MEM_REPORTS, AGGREGATE_INITIAL_SLOTS, sizeof(BookTotals));
+    aggregate->customers = memCalloc(MEM_REPORTS, AGGREGATE_INITIAL_SLOTS, sizeof(CustomerTotals));
+    if (!aggregate->books || !aggregate->customers) {
+        freeSalesAggregate(aggregate);
+        return -1;
+    }
+    aggregate->bookCapacity = AGGREGATE_INITIAL_SLOTS;
+    aggregate->customerCapacity = AGGREGATE_INITIAL_SLOTS;
+    return 0;
+}
+
+void freeSalesAggregate(SalesAggregate *aggregate) {
+    memFree(aggregate->books);
+    memFree(aggregate->customers);
+    aggregate->books = NULL;
+    aggregate->customers = NULL;
+}
+
+// Doubles the book table and re-slots its entries; -1 if memory ran out
+static int growBooks(SalesAggregate *aggregate) {
+    int capacity = aggregate->bookCapacity * 2;
+    BookTotals *books = memCalloc(MEM_REPORTS, capacity, sizeof(BookTotals));
+    if (!books) {
+        return -1;
+    }
+    for (int i = 0; i < aggregate->bookCapacity; i++) {
+        if (aggregate->books[i].ISBN != 0) {
+            unsigned int slot = aggregateSlot(aggregate->books[i].ISBN, capacity);
+            while (books[slot].ISBN != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            books[slot] = aggregate->books[i];
+        }
+    }
+    memFree(aggregate->books);
+    aggregate->books = books;
+    aggregate->bookCapacity = capacity;
+    return 0;
+}
+
+static int growCustomers(SalesAggregate *aggregate) {
+    int capacity = aggregate->customerCapacity * 2;
+    CustomerTotals *customers = memCalloc(MEM_REPORTS, capacity, sizeof(CustomerTotals));
+    if (!customers) {
+        return -1;
+    }
+    for (int i = 0; i < aggregate->customerCapacity; i++) {
+        if (aggregate->customers[i].customerID != 0) {
+            unsigned int slot = aggregateSlot(aggregate->customers[i].customerID, capacity);
+            while (customers[slot].customerID != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            customers[slot] = aggregate->customers[i];
+        }
+    }
+    memFree(aggregate->customers);
+    aggregate->customers = customers;
+    aggregate->customerCapacity = capacity;
+    return 0;
+}
+
+// Find (or claim) the totals slot for an ISBN, growing the table before it
+// passes half full; NULL if memory ran out
+static BookTotals* aggregateBookSlot(SalesAggregate *aggregate, int ISBN) {
+    unsigned int slot = aggregateSlot(ISBN, aggregate->bookCapacity);
+    while (aggregate->books[slot].ISBN != 0) {
+        if (aggregate->books[slot].ISBN == ISBN) {
+            return &aggregate->books[slot];
+        }
+        slot = (slot + 1) & (aggregate->bookCapacity - 1);
+    }
+    if ((aggregate->numBooks + 1) * 2 > aggregate->bookCapacity) {
+        return growBooks(aggregate) == 0 ? aggregateBookSlot(aggregate, ISBN) : NULL;
+    }
+    aggregate->books[slot].ISBN = ISBN;
+    aggregate->numBooks++;
+    return &aggregate->books[slot];
+}
+
+static CustomerTotals* aggregateCustomerSlot(SalesAggregate *aggregate, int customerID) {
+    unsigned int slot = aggregateSlot(customerID, aggregate->customerCapacity);
+    while (aggregate->customers[slot].customerID != 0) {
+        if (aggregate->customers[slot].customerID == customerID) {
+            return &aggregate->customers[slot];
+        }
+        slot = (slot + 1) & (aggregate->customerCapacity - 1);
+    }
+    if ((aggregate->numCustomers + 1) * 2 > aggregate->customerCapacity) {
+        return growCustomers(aggregate) == 0 ? aggregateCustomerSlot(aggregate, customerID) : NULL;
+    }
+    aggregate->customers[slot].customerID = customerID;
+    aggregate->numCustomers++;
+    return &aggregate->customers[slot];
+}
+
+// Fold one sale into the totals; -1 if a table could not grow
+static int aggregateRecordSale(SalesAggregate *aggregate, const Sale *sale) {
+    BookTotals *book = aggregateBookSlot(aggregate, sale->ISBN);
+    CustomerTotals *customer = book ? aggregateCustomerSlot(aggregate, sale->customerID) : NULL;
+    if (!customer) {
+        return -1;
+    }
+    aggregate->numSales++;
+    aggregate->unitsSold += sale->quantity;
+    aggregate->revenue += sale->totalPrice;
+    book->unitsSold += sale->quantity;
+    book->numSales++;
+    book->revenue += sale->totalPrice;
+    addHLL(&book->buyers, sale->customerID);
+    customer->numPurchases++;
+    customer->totalSpent += sale->totalPrice;
+    return 0;
+}
+
+// Add the totals of one worker's partial into another; -1 if a table could not grow
+static int mergeSalesAggregate(SalesAggregate *into, const SalesAggregate *from) {
+    into->numSales += from->numSales;
+    into->unitsSold += from->unitsSold;
+    into->revenue += from->revenue;
+
+    for (int i = 0; i < from->bookCapacity; i++) {
+        const BookTotals *src = &from->books[i];
+        if (src->ISBN == 0) {
+            continue;
+        }
+        BookTotals *book = aggregateBookSlot(into, src->ISBN);
+        if (!book) {
+            return -1;
+        }
+        book->unitsSold += src->unitsSold;
+        book->numSales += src->numSales;
+        book->revenue += src->revenue;
+        mergeHLL(&book->buyers, &src->buyers);
+    }
+
+    for (int i = 0; i < from->customerCapacity; i++) {
+        const CustomerTotals *src = &from->customers[i];
+        if (src->customerID == 0) {
+            continue;
+        }
+        CustomerTotals *customer = aggregateCustomerSlot(into, src->customerID);
+        if (!customer) {
+            return -1;
+        }
+        customer->numPurchases += src->numPurchases;
+        customer->totalSpent += src->totalSpent;
+    }
+    return 0;
+}
+
+static void *aggregateWorker(void *arg) {
+    AggregateTask *task = (AggregateTask *)arg;
+    task->failed = 0;
+    for (int i = task->begin; i < task->end && !task->failed; i++) {
+        task->failed = aggregateRecordSale(&task->partial, &task->sales[i]) != 0;
+    }
+    return NULL;
+}
+
+static int chooseThreadCount(int numSales, int numThreads) {
+    if (numThreads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (numThreads > MAX_AGGREGATE_THREADS) {
+        numThreads = MAX_AGGREGATE_THREADS;
+    }
+    int useful = numSales / MIN_SALES_PER_THREAD;
+    if (numThreads > useful) {
+        numThreads = useful;
+    }
+    return numThreads > 0 ? numThreads : 1;
+}
+
+int aggregateSalesParallel(const Sale *sales, int numSales, int numThreads, SalesAggregate *out) {
+    TRACE_SPAN("aggregateSalesParallel");
+    numThreads = chooseThreadCount(numSales, numThreads);
+    if (initSalesAggregate(out) != 0) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    if (numThreads == 1) {
+        for (int i = 0; i < numSales; i++) {
+            if (aggregateRecordSale(out, &sales[i]) != 0) {
+                perror("Memory allocation failed");
+                freeSalesAggregate(out);
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    pthread_t threads[MAX_AGGREGATE_THREADS];
+    AggregateTask tasks[MAX_AGGREGATE_THREADS];
+    int started[MAX_AGGREGATE_THREADS] = {0};
+
+    // Split the range into contiguous partitions, one per worker
+    for (int t = 0; t < numThreads; t++) {
+        tasks[t].sales = sales;
+        tasks[t].begin = (int)((long long)numSales * t / numThreads);
+        tasks[t].end = (int)((long long)numSales * (t + 1) / numThreads);
+        if (initSalesAggregate(&tasks[t].partial) != 0) {
+            perror("Memory allocation failed");
+            for (int j = 0; j < t; j++) {
+                freeSalesAggregate(&tasks[j].partial);
+            }
+            freeSalesAggregate(out);
+            return -1;
+        }
+    }
+
+    for (int t = 0; t < numThreads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, aggregateWorker, &tasks[t]) == 0;
+        if (!started[t]) {
+            aggregateWorker(&tasks[t]); // Fall back to doing this partition inline
+        }
+    }
+
+    int status = 0;
+    for (int t = 0; t < numThreads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        if (status == 0 && (tasks[t].failed || mergeSalesAggregate(out, &tasks[t].partial) != 0)) {
+            perror("Memory allocation failed");
+            status = -1;
+        }
+        freeSalesAggregate(&tasks[t].partial);
+    }
+    if (status != 0) {
+        freeSalesAggregate(out);
+    }
+    return status;
+}
+
+const BookTotals* getAggregateBookTotals(const SalesAggregate *aggregate, int ISBN) {
+    unsigned int slot = aggregateSlot(ISBN, aggregate->bookCapacity);
+    while (aggregate->books[slot].ISBN != 0) {
+        if (aggregate->books[slot].ISBN == ISBN) {
+            return &aggregate->books[slot];
+        }
+        slot = (slot + 1) & (aggregate->bookCapacity - 1);
+    }
+    return NULL; // No sales recorded for this ISBN
+}
+
+const CustomerTotals* getAggregateCustomerTotals(const SalesAggregate *aggregate, int customerID) {
+    unsigned int slot = aggregateSlot(customerID, aggregate->customerCapacity);
+    while (aggregate->customers[slot].customerID != 0) {
+        if (aggregate->customers[slot].customerID == customerID) {
+            return &aggregate->customers[slot];
+        }
+        slot = (slot + 1) & (aggregate->customerCapacity - 1);
+    }
+    return NULL; // No purchases recorded for this customer
+}
+
+// Function to recompute the store's totals, in parallel once the history is large
+void recomputeSalesStats(SalesStats *stats, const Sale *sales, int numSales) {
+    SalesAggregate aggregate;
+    if (numSales < 2 * MIN_SALES_PER_THREAD || aggregateSalesParallel(sales, numSales, 0, &aggregate) != 0) {
+        rebuildSalesStats(stats, sales, numSales);
+        return;
+    }
+
+    resetSalesStats(stats);
+    stats->numSales = aggregate.numSales;
+    stats->unitsSold = aggregate.unitsSold;
+    stats->revenue = aggregate.revenue;
+    for (int i = 0; i < aggregate.bookCapacity; i++) {
+        if (aggregate.books[i].ISBN != 0) {
+            addBookTotals(stats, &aggregate.books[i]);
+        }
+    }
+    for (int i = 0; i < aggregate.customerCapacity; i++) {
+        if (aggregate.customers[i].customerID != 0) {
+            addCustomerTotals(stats, &aggregate.customers[i]);
+        }
+    }
+    freeSalesAggregate(&aggregate);
+}
@@ -0,0 +1,40 @@
+#ifndef SALES_AGGREGATE_H
+#define SALES_AGGREGATE_H
+
+#include "sales.h"
+#include "sales_stats.h"
+
+#define MAX_AGGREGATE_THREADS 64
+#define MIN_SALES_PER_THREAD 16384 // Below this a partition is not worth a thread
+#define AGGREGATE_INITIAL_SLOTS 64 // Must be a power of two; tables double as they fill
+
+// Sales totals over a history of any size. Unlike SalesStats, whose tables are
+// fixed at STATS_TABLE_SIZE slots, the tables here grow (open addressing, kept
+// at most half full; ISBN / customer ID 0 marks an empty slot).
+typedef struct {
+    BookTotals *books;
+    int bookCapacity;
+    int numBooks;
+    CustomerTotals *customers;
+    int customerCapacity;
+    int numCustomers;
+    int numSales;
+    long unitsSold;
+    double revenue;
+} SalesAggregate;
+
+// Function prototypes (declarations)
+// Aggregates sales[0..numSales) into out using up to numThreads workers
+// (numThreads <= 0 means one per online CPU). Each worker fills a private
+// SalesAggregate and the partials are merged once all workers have joined.
+// Returns 0 on success (release out with freeSalesAggregate), -1 if memory ran out.
+int aggregateSalesParallel(const Sale *sales, int numSales, int numThreads, SalesAggregate *out);
+void freeSalesAggregate(SalesAggregate *aggregate);
+const BookTotals* getAggregateBookTotals(const SalesAggregate *aggregate, int ISBN);
+const CustomerTotals* getAggregateCustomerTotals(const SalesAggregate *aggregate, int customerID);
+
+// Recomputes the store's totals from the history: serially while it is small,
+// with the parallel engine once it spans at least two partitions.
+void recomputeSalesStats(SalesStats *stats, const Sale *sales, int numSales);
+
+#endif // SALES_AGGREGATE_H
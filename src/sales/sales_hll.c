@@ -0,0 +1,88 @@
+#include <math.h>
+#include <string.h>
+#include "sales_hll.h"
+
+// 64-bit finalizer (splitmix64) so sequential IDs spread over all registers
+static uint64_t hashKey(int key) {
+    uint64_t x = (uint64_t)(uint32_t)key + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+void resetHLL(HyperLogLog *hll) {
+    memset(hll->registers, 0, sizeof(hll->registers));
+}
+
+void addHLL(HyperLogLog *hll, int key) {
+    uint64_t hash = hashKey(key);
+    unsigned int index = (unsigned int)(hash >> (64 - HLL_PRECISION));
+    uint64_t rest = hash << HLL_PRECISION;
+
+    // Rank = position of the first set bit in the remaining 54 bits
+    uint8_t rank = 1;
+    while (rank <= 64 - HLL_PRECISION && !(rest & 0x8000000000000000ull)) {
+        rest <<= 1;
+        rank++;
+    }
+    if (rank > hll->registers[index]) {
+        hll->registers[index] = rank;
+    }
+}
+
+void mergeHLL(HyperLogLog *into, const HyperLogLog *from) {
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        if (from->registers[i] > into->registers[i]) {
+            into->registers[i] = from->registers[i];
+        }
+    }
+}
+
+double estimateHLL(const HyperLogLog *hll) {
+    const double m = HLL_REGISTERS;
+    double sum = 0.0;
+    int zeros = 0;
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        sum += ldexp(1.0, -hll->registers[i]);
+        if (hll->registers[i] == 0) {
+            zeros++;
+        }
+    }
+
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Small-range correction: linear counting while registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / zeros);
+    }
+    return estimate;
+}
+
+void formatHLL(const HyperLogLog *hll, char *out) {
+    static const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        out[2 * i] = digits[hll->registers[i] >> 4];
+        out[2 * i + 1] = digits[hll->registers[i] & 0x0F];
+    }
+    out[2 * HLL_REGISTERS] = '\0';
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+int parseHLL(HyperLogLog *hll, const char *hex) {
+    for (int i = 0; i < HLL_REGISTERS; i++) {
+        int high = hexValue(hex[2 * i]);
+        int low = high < 0 ? -1 : hexValue(hex[2 * i + 1]);
+        if (low < 0) {
+            resetHLL(hll);
+            return 0;
+        }
+        hll->registers[i] = (uint8_t)(high << 4 | low);
+    }
+    return 1;
+}
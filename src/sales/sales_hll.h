@@ -0,0 +1,24 @@
+#ifndef SALES_HLL_H
+#define SALES_HLL_H
+
+#include <stdint.h>
+
+// HyperLogLog distinct counter: 2^10 one-byte registers (1 KB per sketch).
+// Standard error is 1.04 / sqrt(1024), about 3.3%; small counts fall back to
+// linear counting and are close to exact.
+#define HLL_PRECISION 10
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+typedef struct {
+    uint8_t registers[HLL_REGISTERS];
+} HyperLogLog;
+
+// Function prototypes (declarations)
+void resetHLL(HyperLogLog *hll);
+void addHLL(HyperLogLog *hll, int key);
+void mergeHLL(HyperLogLog *into, const HyperLogLog *from); // Union, e.g. across threads or shards
+double estimateHLL(const HyperLogLog *hll);
+void formatHLL(const HyperLogLog *hll, char *out);   // out needs 2 * HLL_REGISTERS + 1 bytes
+int parseHLL(HyperLogLog *hll, const char *hex);     // Returns 1 on success
+
+#endif // SALES_HLL_H
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "sales_ingest.h"
+#include "sales_stats.h"
+#include "../book/book_index.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/lock_profile.h"
+#include "../metrics/mem_account.h"
+
+// ISBN -> position in the books array, sorted by ISBN
+typedef struct {
+    int ISBN;
+    int index;
+} BookKey;
+
+// One parsed transaction line
+typedef struct {
+    long line;
+    int customerID;
+    int ISBN;
+    int quantity;
+    long timestamp;
+} IngestRow;
+
+static int compareBookKeys(const void *a, const void *b) {
+    const BookKey *x = a, *y = b;
+    return (x->ISBN > y->ISBN) - (x->ISBN < y->ISBN);
+}
+
+static int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int findBookKey(const BookKey *keys, int numKeys, int ISBN) {
+    int low = 0, high = numKeys - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (keys[mid].ISBN == ISBN) {
+            return keys[mid].index;
+        }
+        if (keys[mid].ISBN < ISBN) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+static int compareRejects(const void *a, const void *b) {
+    const IngestReject *x = a, *y = b;
+    return (x->line > y->line) - (x->line < y->line);
+}
+
+static void addReject(IngestResult *result, long line, const char *reason) {
+    result->rowsRejected++;
+    if (result->numRejects < MAX_INGEST_REJECTS) {
+        IngestReject *reject = &result->rejects[result->numRejects++];
+        reject->line = line;
+        strncpy(reject->reason, reason, MAX_REJECT_REASON - 1);
+        reject->reason[MAX_REJECT_REASON - 1] = '\0';
+    }
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Sorts the catalog's ISBNs with their positions; the caller holds bookMutex
+static void buildBookKeys(const Book *books, int numBooks, BookKey *bookKeys) {
+    for (int i = 0; i < numBooks; i++) {
+        bookKeys[i].ISBN = books[i].ISBN;
+        bookKeys[i].index = i;
+    }
+    qsort(bookKeys, numBooks, sizeof(BookKey), compareBookKeys);
+}
+
+// Position of the book with the ISBN, or -1. The keys are built once per run;
+// if a lookup misses or lands on a moved book, the catalog changed between
+// chunks, so they are rebuilt (at most once per chunk) and the lookup retried.
+static int lookupBook(const Book *books, int numBooks, BookKey *bookKeys, int *rebuilt, int ISBN) {
+    int index = findBookKey(bookKeys, numBooks, ISBN);
+    if ((index < 0 || books[index].ISBN != ISBN) && !*rebuilt) {
+        buildBookKeys(books, numBooks, bookKeys);
+        *rebuilt = 1;
+        index = findBookKey(bookKeys, numBooks, ISBN);
+    }
+    return index >= 0 && books[index].ISBN == ISBN ? index : -1;
+}
+
+// Validate and apply one chunk of rows under a single hold of bookMutex
+static void applyChunk(const IngestRow *rows, int numRows, Book *books, int numBooks, BookKey *bookKeys,
+                       const int *customerIDs, int numCustomers, Sale *sales, int *numSales, IngestResult *result) {
+    PROFILED_LOCK(&bookMutex);
+    int rebuilt = 0;
+
+    Sale *chunkSales = &sales[*numSales];
+    int accepted = 0;
+    int nextID = (*numSales > 0) ? sales[*numSales - 1].saleID + 1 : 1;
+    time_t now = time(NULL);
+
+    for (int r = 0; r < numRows; r++) {
+        const IngestRow *row = &rows[r];
+        if (!bsearch(&row->customerID, customerIDs, numCustomers, sizeof(int), compareInts)) {
+            addReject(result, row->line, "unknown customer");
+            continue;
+        }
+        int index = lookupBook(books, numBooks, bookKeys, &rebuilt, row->ISBN);
+        if (index < 0) {
+            addReject(result, row->line, "unknown ISBN");
+            continue;
+        }
+        if (row->quantity <= 0) {
+            addReject(result, row->line, "invalid quantity");
+            continue;
+        }
+        if (books[index].quantity < row->quantity) {
+            addReject(result, row->line, "insufficient stock");
+            continue;
+        }
+        if (*numSales + accepted >= MAX_SALES) {
+            addReject(result, row->line, "sales store full");
+            continue;
+        }
+
+        Book before = books[index];
+        books[index].quantity -= row->quantity;
+        indexUpdateBook(&before, &books[index]);
+        Sale *sale = &chunkSales[accepted];
+        sale->saleID = nextID + accepted;
+        sale->customerID = row->customerID;
+        sale->ISBN = row->ISBN;
+        sale->quantity = row->quantity;
+        sale->totalPrice = books[index].price * row->quantity;
+        sale->timestamp = row->timestamp > 0 ? (time_t)row->timestamp : now;
+        trackSale(sale);
+        accepted++;
+    }
+
+    *numSales += accepted;
+    result->rowsAccepted += accepted;
+    if (accepted > 0) {
+        appendSales(chunkSales, accepted);
+    }
+
+    PROFILED_UNLOCK(&bookMutex);
+}
+
+// Function to replay a register log in bulk
+int ingestTransactions(const char *path, Book *books, int numBooks, const Customer *customers, int numCustomers,
+                       Sale *sales, int *numSales, IngestResult *result) {
+    OP_LATENCY_SCOPE(OP_INGEST_TRANSACTIONS);
+    memset(result, 0, sizeof(*result));
+    double start = nowSeconds();
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("Error opening transaction file for reading");
+        return -1;
+    }
+
+    BookKey *bookKeys = memAlloc(MEM_INDEXES, (numBooks > 0 ? numBooks : 1) * sizeof(BookKey));
+    int *customerIDs = memAlloc(MEM_INDEXES, (numCustomers > 0 ? numCustomers : 1) * sizeof(int));
+    IngestRow *rows = memAlloc(MEM_SALES, INGEST_CHUNK_ROWS * sizeof(IngestRow));
+    if (!bookKeys || !customerIDs || !rows) {
+        perror("Memory allocation failed");
+        memFree(bookKeys);
+        memFree(customerIDs);
+        memFree(rows);
+        fclose(file);
+        return -1;
+    }
+
+    // Customer IDs are stable for the whole run (the caller holds the customer lock)
+    for (int i = 0; i < numCustomers; i++) {
+        customerIDs[i] = customers[i].customerID;
+    }
+    qsort(customerIDs, numCustomers, sizeof(int), compareInts);
+    PROFILED_LOCK(&bookMutex);
+    buildBookKeys(books, numBooks, bookKeys);
+    PROFILED_UNLOCK(&bookMutex);
+
+    char line[256];
+    long lineNumber = 0;
+    int numRows = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char *text = line + strspn(line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\0') {
+            continue;
+        }
+        result->rowsRead++;
+
+        IngestRow *row = &rows[numRows];
+        row->line = lineNumber;
+        row->timestamp = 0;
+        if (sscanf(text, "%d %d %d %ld", &row->customerID, &row->ISBN, &row->quantity, &row->timestamp) < 3) {
+            addReject(result, lineNumber, "malformed row");
+            continue;
+        }
+
+        if (++numRows == INGEST_CHUNK_ROWS) {
+            applyChunk(rows, numRows, books, numBooks, bookKeys, customerIDs, numCustomers, sales, numSales, result);
+            numRows = 0;
+        }
+    }
+    if (numRows > 0) {
+        applyChunk(rows, numRows, books, numBooks, bookKeys, customerIDs, numCustomers, sales, numSales, result);
+    }
+
+    if (ferror(file)) {
+        perror("Error reading transaction file");
+    }
+    fclose(file);
+    memFree(bookKeys);
+    memFree(customerIDs);
+    memFree(rows);
+
+    // Stock is saved and the totals checkpointed once for the whole run
+    if (result->rowsAccepted > 0) {
+        PROFILED_LOCK(&bookMutex);
+        saveBooks(books, numBooks);
+        checkpointSalesStats(&salesStats); // The totals are guarded by bookMutex too
+        PROFILED_UNLOCK(&bookMutex);
+    }
+
+    // Parse rejects are recorded before chunk rejects, so restore file order
+    qsort(result->rejects, result->numRejects, sizeof(IngestReject), compareRejects);
+
+    result->seconds = nowSeconds() - start;
+    result->rowsPerSecond = result->seconds > 0 ? result->rowsRead / result->seconds : 0.0;
+    return 0;
+}
+
+void displayIngestResult(const IngestResult *result) {
+    printf("\nIngest Summary:\n");
+    printf("Rows Read: %ld, Accepted: %ld, Rejected: %ld\n",
+           result->rowsRead, result->rowsAccepted, result->rowsRejected);
+    printf("Elapsed: %.3f s, Throughput: %.0f rows/s\n", result->seconds, result->rowsPerSecond);
+
+    if (result->numRejects > 0) {
+        printf("\nRejected Rows:\n");
+        for (int i = 0; i < result->numRejects; i++) {
+            printf("Line %ld: %s\n", result->rejects[i].line, result->rejects[i].reason);
+        }
+        if (result->rowsRejected > result->numRejects) {
+            printf("... and %ld more\n", result->rowsRejected - result->numRejects);
+        }
+    }
+}
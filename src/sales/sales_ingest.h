@@ -0,0 +1,34 @@
+#ifndef SALES_INGEST_H
+#define SALES_INGEST_H
+
+#include "sales.h"
+
+#define INGEST_CHUNK_ROWS 4096   // Rows validated and appended per lock hold
+#define MAX_INGEST_REJECTS 1000  // Rejects kept for reporting (the count is always exact)
+#define MAX_REJECT_REASON 64
+
+// A transaction line that could not be applied
+typedef struct {
+    long line;
+    char reason[MAX_REJECT_REASON];
+} IngestReject;
+
+typedef struct {
+    long rowsRead;
+    long rowsAccepted;
+    long rowsRejected;
+    double seconds;
+    double rowsPerSecond;
+    int numRejects; // Entries stored in rejects (at most MAX_INGEST_REJECTS)
+    IngestReject rejects[MAX_INGEST_REJECTS];
+} IngestResult;
+
+// Function prototypes (declarations)
+// Replays a register log with one "customerID ISBN quantity [timestamp]" row per
+// line ('#' starts a comment). Rows are validated against sorted ISBN and customer
+// indexes and applied in chunks; returns 0, or -1 if the file could not be read.
+int ingestTransactions(const char *path, Book *books, int numBooks, const Customer *customers, int numCustomers,
+                       Sale *sales, int *numSales, IngestResult *result);
+void displayIngestResult(const IngestResult *result);
+
+#endif // SALES_INGEST_H
@@ -1,3 +1,263 @@
 //
 // Created by omar on 27.05.2024.
 //
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "sales_report.h"
+#include "../metrics/op_latency.h"
+#include "../metrics/mem_account.h"
+
+int openReportWriter(ReportWriter *writer, int fd) {
+    writer->fd = fd;
+    writer->used = 0;
+    writer->failed = 0;
+    writer->bytesWritten = 0;
+    writer->buffer = memAlloc(MEM_REPORTS, REPORT_BUFFER_SIZE);
+    if (!writer->buffer) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    return 0;
+}
+
+void flushReportWriter(ReportWriter *writer) {
+    size_t offset = 0;
+    while (!writer->failed && offset < writer->used) {
+        ssize_t written = write(writer->fd, writer->buffer + offset, writer->used - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Error writing report");
+            writer->failed = 1;
+            break;
+        }
+        offset += (size_t)written;
+        writer->bytesWritten += written;
+    }
+    writer->used = 0;
+}
+
+int closeReportWriter(ReportWriter *writer) {
+    flushReportWriter(writer);
+    memFree(writer->buffer);
+    writer->buffer = NULL;
+    return writer->failed ? -1 : 0;
+}
+
+// Make room for length bytes, flushing if needed
+static char *reserve(ReportWriter *writer, size_t length) {
+    if (writer->used + length > REPORT_BUFFER_SIZE) {
+        flushReportWriter(writer);
+    }
+    return writer->buffer + writer->used;
+}
+
+void reportWrite(ReportWriter *writer, const char *data, size_t length) {
+    while (length > 0) {
+        size_t room = REPORT_BUFFER_SIZE - writer->used;
+        if (room == 0) {
+            flushReportWriter(writer);
+            room = REPORT_BUFFER_SIZE;
+        }
+        size_t chunk = length < room ? length : room;
+        memcpy(writer->buffer + writer->used, data, chunk);
+        writer->used += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void reportWriteString(ReportWriter *writer, const char *text) {
+    reportWrite(writer, text, strlen(text));
+}
+
+// Hand-rolled integer formatting (no printf per field)
+void reportWriteInt(ReportWriter *writer, long long value) {
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[sizeof(digits) - 1 - length++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[sizeof(digits) - 1 - length++] = '-';
+    }
+
+    char *out = reserve(writer, (size_t)length);
+    memcpy(out, digits + sizeof(digits) - length, (size_t)length);
+    writer->used += (size_t)length;
+}
+
+// Prices are written with exactly two decimals, rounded half away from zero
+void reportWritePrice(ReportWriter *writer, double value) {
+    int negative = value < 0;
+    long long cents = (long long)((negative ? -value : value) * 100.0 + 0.5);
+    if (negative && cents > 0) {
+        reportWrite(writer, "-", 1);
+    }
+    reportWriteInt(writer, cents / 100);
+
+    char *out = reserve(writer, 3);
+    out[0] = '.';
+    out[1] = (char)('0' + (cents % 100) / 10);
+    out[2] = (char)('0' + cents % 10);
+    writer->used += 3;
+}
+
+// CSV field, quoted only when it contains a separator, quote or newline
+void reportWriteCsvField(ReportWriter *writer, const char *text) {
+    if (!strpbrk(text, ",\"\n\r")) {
+        reportWriteString(writer, text);
+        return;
+    }
+    reportWrite(writer, "\"", 1);
+    for (const char *c = text; *c; c++) {
+        if (*c == '"') {
+            reportWrite(writer, "\"\"", 2);
+        } else {
+            reportWrite(writer, c, 1);
+        }
+    }
+    reportWrite(writer, "\"", 1);
+}
+
+void reportWriteJsonString(ReportWriter *writer, const char *text) {
+    static const char hex[] = "0123456789abcdef";
+    reportWrite(writer, "\"", 1);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            char escaped[2] = {'\\', (char)*c};
+            reportWrite(writer, escaped, 2);
+        } else if (*c < 0x20) {
+            char escaped[6] = {'\\', 'u', '0', '0', hex[*c >> 4], hex[*c & 0x0F]};
+            reportWrite(writer, escaped, 6);
+        } else {
+            reportWrite(writer, (const char *)c, 1);
+        }
+    }
+    reportWrite(writer, "\"", 1);
+}
+
+static void writeSaleRow(ReportWriter *writer, const Sale *sale, ReportFormat format, int first) {
+    if (format == REPORT_CSV) {
+        reportWriteInt(writer, sale->saleID);
+        reportWrite(writer, ",", 1);
+        reportWriteInt(writer, sale->customerID);
+        reportWrite(writer, ",", 1);
+        reportWriteInt(writer, sale->ISBN);
+        reportWrite(writer, ",", 1);
+        reportWriteInt(writer, sale->quantity);
+        reportWrite(writer, ",", 1);
+        reportWritePrice(writer, sale->totalPrice);
+        reportWrite(writer, ",", 1);
+        reportWriteInt(writer, (long long)sale->timestamp);
+        reportWrite(writer, "\n", 1);
+    } else {
+        reportWriteString(writer, first ? "\n{\"saleID\":" : ",\n{\"saleID\":");
+        reportWriteInt(writer, sale->saleID);
+        reportWriteString(writer, ",\"customerID\":");
+        reportWriteInt(writer, sale->customerID);
+        reportWriteString(writer, ",\"ISBN\":");
+        reportWriteInt(writer, sale->ISBN);
+        reportWriteString(writer, ",\"quantity\":");
+        reportWriteInt(writer, sale->quantity);
+        reportWriteString(writer, ",\"totalPrice\":");
+        reportWritePrice(writer, sale->totalPrice);
+        reportWriteString(writer, ",\"timestamp\":");
+        reportWriteInt(writer, (long long)sale->timestamp);
+        reportWrite(writer, "}", 1);
+    }
+}
+
+// Function to stream every sale as CSV or a JSON array
+long exportSales(const Sale *sales, int numSales, ReportFormat format, int fd) {
+    OP_LATENCY_SCOPE(OP_EXPORT_REPORT);
+    ReportWriter writer;
+    if (openReportWriter(&writer, fd) != 0) {
+        return -1;
+    }
+
+    reportWriteString(&writer, format == REPORT_CSV
+                               ? "sale_id,customer_id,isbn,quantity,total_price,timestamp\n"
+                               : "[");
+    for (int i = 0; i < numSales && !writer.failed; i++) {
+        writeSaleRow(&writer, &sales[i], format, i == 0);
+    }
+    if (format == REPORT_JSON) {
+        reportWriteString(&writer, "\n]\n");
+    }
+
+    return closeReportWriter(&writer) == 0 ? numSales : -1;
+}
+
+// Function to stream the per-title totals as CSV or a JSON array
+long exportBookTotals(const SalesStats *stats, ReportFormat format, int fd) {
+    OP_LATENCY_SCOPE(OP_EXPORT_REPORT);
+    ReportWriter writer;
+    if (openReportWriter(&writer, fd) != 0) {
+        return -1;
+    }
+
+    long rows = 0;
+    reportWriteString(&writer, format == REPORT_CSV
+                               ? "isbn,copies_sold,num_sales,revenue,unique_buyers\n"
+                               : "[");
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        const BookTotals *book = &stats->books[i];
+        if (book->ISBN == 0) {
+            continue;
+        }
+        long long buyers = (long long)(estimateHLL(&book->buyers) + 0.5);
+        if (format == REPORT_CSV) {
+            reportWriteInt(&writer, book->ISBN);
+            reportWrite(&writer, ",", 1);
+            reportWriteInt(&writer, book->unitsSold);
+            reportWrite(&writer, ",", 1);
+            reportWriteInt(&writer, book->numSales);
+            reportWrite(&writer, ",", 1);
+            reportWritePrice(&writer, book->revenue);
+            reportWrite(&writer, ",", 1);
+            reportWriteInt(&writer, buyers);
+            reportWrite(&writer, "\n", 1);
+        } else {
+            reportWriteString(&writer, rows == 0 ? "\n{\"ISBN\":" : ",\n{\"ISBN\":");
+            reportWriteInt(&writer, book->ISBN);
+            reportWriteString(&writer, ",\"copiesSold\":");
+            reportWriteInt(&writer, book->unitsSold);
+            reportWriteString(&writer, ",\"numSales\":");
+            reportWriteInt(&writer, book->numSales);
+            reportWriteString(&writer, ",\"revenue\":");
+            reportWritePrice(&writer, book->revenue);
+            reportWriteString(&writer, ",\"uniqueBuyers\":");
+            reportWriteInt(&writer, buyers);
+            reportWrite(&writer, "}", 1);
+        }
+        rows++;
+    }
+    if (format == REPORT_JSON) {
+        reportWriteString(&writer, "\n]\n");
+    }
+
+    return closeReportWriter(&writer) == 0 ? rows : -1;
+}
+
+long exportSalesToFile(const Sale *sales, int numSales, ReportFormat format, const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Error opening export file for writing");
+        return -1;
+    }
+    long rows = exportSales(sales, numSales, format, fd);
+    if (close(fd) != 0) {
+        perror("Error closing export file");
+        rows = -1;
+    }
+    return rows;
+}
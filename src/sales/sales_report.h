@@ -0,0 +1,45 @@
+//
+// Created by omar on 27.05.2024.
+//
+
+#ifndef SALES_REPORT_H
+#define SALES_REPORT_H
+
+#include <stddef.h>
+#include "sales.h"
+#include "sales_stats.h"
+
+#define REPORT_BUFFER_SIZE (256 * 1024) // Bytes staged before each write()
+
+typedef enum {
+    REPORT_CSV,
+    REPORT_JSON
+} ReportFormat;
+
+// Buffered writer over a file descriptor: rows are formatted straight into
+// the buffer and handed to the kernel in REPORT_BUFFER_SIZE chunks.
+typedef struct {
+    int fd;
+    char *buffer;
+    size_t used;
+    int failed;              // Set once a write() fails; later output is dropped
+    long long bytesWritten;
+} ReportWriter;
+
+// Function prototypes (declarations)
+int openReportWriter(ReportWriter *writer, int fd);
+void flushReportWriter(ReportWriter *writer);
+int closeReportWriter(ReportWriter *writer); // Flushes and frees; returns 0 on success, -1 on error
+void reportWrite(ReportWriter *writer, const char *data, size_t length);
+void reportWriteString(ReportWriter *writer, const char *text);
+void reportWriteInt(ReportWriter *writer, long long value);
+void reportWritePrice(ReportWriter *writer, double value);
+void reportWriteCsvField(ReportWriter *writer, const char *text);
+void reportWriteJsonString(ReportWriter *writer, const char *text);
+
+// Exports return the number of rows written, or -1 on error
+long exportSales(const Sale *sales, int numSales, ReportFormat format, int fd);
+long exportBookTotals(const SalesStats *stats, ReportFormat format, int fd);
+long exportSalesToFile(const Sale *sales, int numSales, ReportFormat format, const char *path);
+
+#endif // SALES_REPORT_H
@@ -0,0 +1,118 @@
+#include <string.h>
+#include "sales_rollup.h"
+#include "../metrics/trace.h"
+
+// Global rollups (guarded by the lock that guards the sales array)
+SalesRollup salesRollup;
+
+// Add a sale to the ring slot for its period, recycling the slot if it holds an older period
+static void addToBucket(RollupBucket *ring, int ringSize, long period, const Sale *sale) {
+    RollupBucket *bucket = &ring[period % ringSize];
+    if (bucket->period > period) {
+        return; // Older than the retained window
+    }
+    if (bucket->period != period) {
+        bucket->period = period;
+        bucket->numSales = 0;
+        bucket->unitsSold = 0;
+        bucket->revenue = 0.0;
+    }
+    bucket->numSales++;
+    bucket->unitsSold += sale->quantity;
+    bucket->revenue += sale->totalPrice;
+}
+
+// Add the ring slot for a period to result, if it is still retained
+static void addFromBucket(const RollupBucket *ring, int ringSize, long period, RollupBucket *result) {
+    const RollupBucket *bucket = &ring[period % ringSize];
+    if (bucket->period == period) {
+        result->numSales += bucket->numSales;
+        result->unitsSold += bucket->unitsSold;
+        result->revenue += bucket->revenue;
+    }
+}
+
+void resetSalesRollup(SalesRollup *rollup) {
+    for (int i = 0; i < HOURLY_BUCKETS; i++) {
+        memset(&rollup->hours[i], 0, sizeof(RollupBucket));
+        rollup->hours[i].period = -1;
+    }
+    for (int i = 0; i < DAILY_BUCKETS; i++) {
+        memset(&rollup->days[i], 0, sizeof(RollupBucket));
+        rollup->days[i].period = -1;
+        resetHLL(&rollup->dayBuyers[i]);
+    }
+}
+
+// Fold one sale into its hour and day buckets in O(1)
+void recordSaleRollup(SalesRollup *rollup, const Sale *sale) {
+    if (sale->timestamp <= 0) {
+        return; // Legacy sale without a timestamp
+    }
+    addToBucket(rollup->hours, HOURLY_BUCKETS, (long)(sale->timestamp / SECONDS_PER_HOUR), sale);
+
+    long day = (long)(sale->timestamp / SECONDS_PER_DAY);
+    int slot = (int)(day % DAILY_BUCKETS);
+    if (rollup->days[slot].period < day) {
+        resetHLL(&rollup->dayBuyers[slot]); // The day bucket is about to be recycled
+    }
+    addToBucket(rollup->days, DAILY_BUCKETS, day, sale);
+    if (rollup->days[slot].period == day) {
+        addHLL(&rollup->dayBuyers[slot], sale->customerID);
+    }
+}
+
+void rebuildSalesRollup(SalesRollup *rollup, const Sale *sales, int numSales) {
+    TRACE_SPAN("rebuildSalesRollup");
+    resetSalesRollup(rollup);
+    for (int i = 0; i < numSales; i++) {
+        recordSaleRollup(rollup, &sales[i]);
+    }
+}
+
+void querySalesRange(const SalesRollup *rollup, time_t from, time_t to, RollupBucket *result) {
+    memset(result, 0, sizeof(*result));
+    result->period = -1;
+    if (to <= from) {
+        return;
+    }
+
+    const long hoursPerDay = SECONDS_PER_DAY / SECONDS_PER_HOUR;
+    long hour = (long)(from / SECONDS_PER_HOUR);
+    long endHour = (long)((to + SECONDS_PER_HOUR - 1) / SECONDS_PER_HOUR);
+
+    // Leading partial day, hour by hour
+    while (hour < endHour && hour % hoursPerDay != 0) {
+        addFromBucket(rollup->hours, HOURLY_BUCKETS, hour, result);
+        hour++;
+    }
+
+    // Whole days
+    while (hour + hoursPerDay <= endHour) {
+        addFromBucket(rollup->days, DAILY_BUCKETS, hour / hoursPerDay, result);
+        hour += hoursPerDay;
+    }
+
+    // Trailing partial day
+    while (hour < endHour) {
+        addFromBucket(rollup->hours, HOURLY_BUCKETS, hour, result);
+        hour++;
+    }
+}
+
+double estimateUniqueCustomers(const SalesRollup *rollup, time_t from, time_t to) {
+    if (to <= from) {
+        return 0.0;
+    }
+
+    HyperLogLog merged;
+    resetHLL(&merged);
+    long lastDay = (long)((to - 1) / SECONDS_PER_DAY);
+    for (long day = (long)(from / SECONDS_PER_DAY); day <= lastDay; day++) {
+        int slot = (int)(day % DAILY_BUCKETS);
+        if (rollup->days[slot].period == day) {
+            mergeHLL(&merged, &rollup->dayBuyers[slot]);
+        }
+    }
+    return estimateHLL(&merged);
+}
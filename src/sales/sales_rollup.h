@@ -0,0 +1,42 @@
+#ifndef SALES_ROLLUP_H
+#define SALES_ROLLUP_H
+
+#include <time.h>
+#include "sales.h"
+#include "sales_hll.h"
+
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+#define HOURLY_BUCKETS (24 * 62) // About two months of hourly detail
+#define DAILY_BUCKETS 400        // About thirteen months of daily detail
+
+// Totals for one hour or one day (period is hours/days since the epoch, -1 when empty)
+typedef struct {
+    long period;
+    int numSales;
+    long unitsSold;
+    double revenue;
+} RollupBucket;
+
+// Ring buffers of hourly and daily totals, maintained as sales are processed.
+// Protected by the same lock as the sales array.
+typedef struct {
+    RollupBucket hours[HOURLY_BUCKETS];
+    RollupBucket days[DAILY_BUCKETS];
+    HyperLogLog dayBuyers[DAILY_BUCKETS]; // Distinct customers per day, parallel to days
+} SalesRollup;
+
+extern SalesRollup salesRollup;
+
+// Function prototypes (declarations)
+void resetSalesRollup(SalesRollup *rollup);
+void recordSaleRollup(SalesRollup *rollup, const Sale *sale);
+void rebuildSalesRollup(SalesRollup *rollup, const Sale *sales, int numSales);
+// Sums sales in [from, to), widened to whole hours. Whole days inside the range
+// come from the daily buckets, the ragged edges from the hourly ones; periods
+// older than the retained window count as zero.
+void querySalesRange(const SalesRollup *rollup, time_t from, time_t to, RollupBucket *result);
+// Approximate distinct customers over the days overlapping [from, to)
+double estimateUniqueCustomers(const SalesRollup *rollup, time_t from, time_t to);
+
+#endif // SALES_ROLLUP_H
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <string.h>
+#include "sales_stats.h"
+#include "../metrics/trace.h"
+
+// Global aggregates (guarded by the lock that guards the sales array)
+SalesStats salesStats;
+
+// Sales covered by the last snapshot written, so checkpoints can skip the rewrite
+static int checkpointedSales = -1;
+
+// Multiplicative hash of a positive key into the stats tables
+static unsigned int statsSlot(int key) {
+    return ((unsigned int)key * 2654435761u) & (STATS_TABLE_SIZE - 1);
+}
+
+// Find (or claim) the totals slot for an ISBN; NULL if the table is full
+static BookTotals* bookSlot(SalesStats *stats, int ISBN) {
+    unsigned int slot = statsSlot(ISBN);
+    for (int probe = 0; probe < STATS_TABLE_SIZE; probe++) {
+        BookTotals *entry = &stats->books[slot];
+        if (entry->ISBN == ISBN) {
+            return entry;
+        }
+        if (entry->ISBN == 0) {
+            entry->ISBN = ISBN;
+            return entry;
+        }
+        slot = (slot + 1) & (STATS_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+// Find (or claim) the totals slot for a customer; NULL if the table is full
+static CustomerTotals* customerSlot(SalesStats *stats, int customerID) {
+    unsigned int slot = statsSlot(customerID);
+    for (int probe = 0; probe < STATS_TABLE_SIZE; probe++) {
+        CustomerTotals *entry = &stats->customers[slot];
+        if (entry->customerID == customerID) {
+            return entry;
+        }
+        if (entry->customerID == 0) {
+            entry->customerID = customerID;
+            return entry;
+        }
+        slot = (slot + 1) & (STATS_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+void resetSalesStats(SalesStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+// Fold one sale into the totals in O(1)
+void recordSaleStats(SalesStats *stats, const Sale *sale) {
+    stats->numSales++;
+    stats->unitsSold += sale->quantity;
+    stats->revenue += sale->totalPrice;
+
+    BookTotals *book = bookSlot(stats, sale->ISBN);
+    if (book) {
+        book->unitsSold += sale->quantity;
+        book->numSales++;
+        book->revenue += sale->totalPrice;
+        addHLL(&book->buyers, sale->customerID);
+    } else {
+        fprintf(stderr, "Error: Sales stats table full, ISBN %d not tracked.\n", sale->ISBN);
+    }
+
+    CustomerTotals *customer = customerSlot(stats, sale->customerID);
+    if (customer) {
+        customer->numPurchases++;
+        customer->totalSpent += sale->totalPrice;
+    } else {
+        fprintf(stderr, "Error: Sales stats table full, customer %d not tracked.\n", sale->customerID);
+    }
+}
+
+// Recompute the totals from the full sales history
+void rebuildSalesStats(SalesStats *stats, const Sale *sales, int numSales) {
+    resetSalesStats(stats);
+    for (int i = 0; i < numSales; i++) {
+        recordSaleStats(stats, &sales[i]);
+    }
+}
+
+// Function to add one title's partial totals (from a worker or a larger aggregate)
+void addBookTotals(SalesStats *stats, const BookTotals *totals) {
+    BookTotals *book = bookSlot(stats, totals->ISBN);
+    if (book) {
+        book->unitsSold += totals->unitsSold;
+        book->numSales += totals->numSales;
+        book->revenue += totals->revenue;
+        mergeHLL(&book->buyers, &totals->buyers);
+    } else {
+        fprintf(stderr, "Error: Sales stats table full, ISBN %d not tracked.\n", totals->ISBN);
+    }
+}
+
+// Function to add one customer's partial totals
+void addCustomerTotals(SalesStats *stats, const CustomerTotals *totals) {
+    CustomerTotals *customer = customerSlot(stats, totals->customerID);
+    if (customer) {
+        customer->numPurchases += totals->numPurchases;
+        customer->totalSpent += totals->totalSpent;
+    } else {
+        fprintf(stderr, "Error: Sales stats table full, customer %d not tracked.\n", totals->customerID);
+    }
+}
+
+// Add the totals of one partial aggregate into another
+void mergeSalesStats(SalesStats *into, const SalesStats *from) {
+    into->numSales += from->numSales;
+    into->unitsSold += from->unitsSold;
+    into->revenue += from->revenue;
+
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        if (from->books[i].ISBN != 0) {
+            addBookTotals(into, &from->books[i]);
+        }
+    }
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        if (from->customers[i].customerID != 0) {
+            addCustomerTotals(into, &from->customers[i]);
+        }
+    }
+}
+
+const BookTotals* getBookTotals(const SalesStats *stats, int ISBN) {
+    unsigned int slot = statsSlot(ISBN);
+    for (int probe = 0; probe < STATS_TABLE_SIZE; probe++) {
+        const BookTotals *entry = &stats->books[slot];
+        if (entry->ISBN == ISBN) {
+            return entry;
+        }
+        if (entry->ISBN == 0) {
+            break;
+        }
+        slot = (slot + 1) & (STATS_TABLE_SIZE - 1);
+    }
+    return NULL; // No sales recorded for this ISBN
+}
+
+const CustomerTotals* getCustomerTotals(const SalesStats *stats, int customerID) {
+    unsigned int slot = statsSlot(customerID);
+    for (int probe = 0; probe < STATS_TABLE_SIZE; probe++) {
+        const CustomerTotals *entry = &stats->customers[slot];
+        if (entry->customerID == customerID) {
+            return entry;
+        }
+        if (entry->customerID == 0) {
+            break;
+        }
+        slot = (slot + 1) & (STATS_TABLE_SIZE - 1);
+    }
+    return NULL; // No purchases recorded for this customer
+}
+
+// Function to save the aggregates alongside the sales snapshot
+void saveSalesStats(const SalesStats *stats) {
+    TRACE_SPAN("saveSalesStats");
+    FILE *file = fopen(SALES_STATS_DATA_FILE, "w");
+    if (!file) {
+        perror("Error opening sales stats file for writing");
+        return;
+    }
+
+    char sketch[2 * HLL_REGISTERS + 1];
+    fprintf(file, "T %d %ld %.2f\n", stats->numSales, stats->unitsSold, stats->revenue);
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        const BookTotals *book = &stats->books[i];
+        if (book->ISBN != 0) {
+            formatHLL(&book->buyers, sketch);
+            fprintf(file, "B %d %d %d %.2f %s\n", book->ISBN, book->unitsSold, book->numSales, book->revenue, sketch);
+        }
+    }
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        const CustomerTotals *customer = &stats->customers[i];
+        if (customer->customerID != 0) {
+            fprintf(file, "C %d %d %.2f\n", customer->customerID, customer->numPurchases, customer->totalSpent);
+        }
+    }
+
+    if (ferror(file)) {
+        perror("Error writing sales stats file");
+    } else {
+        checkpointedSales = stats->numSales;
+    }
+    fclose(file);
+}
+
+// Function to snapshot the aggregates once STATS_CHECKPOINT_INTERVAL sales have
+// accrued (book rows carry a 2 KB buyers sketch, too much to rewrite per sale)
+void checkpointSalesStats(const SalesStats *stats) {
+    if (checkpointedSales < 0 || stats->numSales - checkpointedSales >= STATS_CHECKPOINT_INTERVAL
+        || stats->numSales < checkpointedSales) {
+        saveSalesStats(stats);
+    }
+}
+
+// Function to load the aggregates; returns 1 on success, 0 if they must be rebuilt
+int loadSalesStats(SalesStats *stats) {
+    TRACE_SPAN("loadSalesStats");
+    resetSalesStats(stats);
+
+    FILE *file = fopen(SALES_STATS_DATA_FILE, "r");
+    if (!file) {
+        return 0;
+    }
+
+    char line[2 * HLL_REGISTERS + 128]; // Book rows carry a hex-encoded buyers sketch
+    int haveTotals = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), file)) {
+        int key, count, extra, sketchStart = 0;
+        double amount;
+        if (line[0] == 'T') {
+            ok = sscanf(line, "T %d %ld %lf", &stats->numSales, &stats->unitsSold, &stats->revenue) == 3;
+            haveTotals = ok;
+        } else if (line[0] == 'B') {
+            ok = sscanf(line, "B %d %d %d %lf %n", &key, &count, &extra, &amount, &sketchStart) == 4 && key != 0
+                 && sketchStart > 0;
+            BookTotals *book = ok ? bookSlot(stats, key) : NULL;
+            if (book) {
+                book->unitsSold = count;
+                book->numSales = extra;
+                book->revenue = amount;
+            }
+            ok = ok && book && parseHLL(&book->buyers, line + sketchStart);
+        } else if (line[0] == 'C') {
+            ok = sscanf(line, "C %d %d %lf", &key, &count, &amount) == 3 && key != 0;
+            CustomerTotals *customer = ok ? customerSlot(stats, key) : NULL;
+            if (customer) {
+                customer->numPurchases = count;
+                customer->totalSpent = amount;
+            }
+            ok = ok && customer;
+        }
+    }
+    fclose(file);
+
+    if (!ok || !haveTotals) {
+        fprintf(stderr, "Warning: Sales stats file is corrupt, rebuilding from sales.\n");
+        resetSalesStats(stats);
+        return 0;
+    }
+    checkpointedSales = stats->numSales;
+    return 1;
+}
+
+// Function to fold in the sales appended since the loaded snapshot. The history
+// is append-only, so the snapshot covers its first stats->numSales records.
+// Returns 1 if the totals now match the history, 0 if they must be rebuilt.
+int catchUpSalesStats(SalesStats *stats, const Sale *sales, int numSales) {
+    if (stats->numSales > numSales) {
+        return 0; // The history was truncated or replaced behind the snapshot's back
+    }
+    for (int i = stats->numSales; i < numSales; i++) {
+        recordSaleStats(stats, &sales[i]);
+    }
+    return 1;
+}
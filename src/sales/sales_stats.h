@@ -0,0 +1,53 @@
+#ifndef SALES_STATS_H
+#define SALES_STATS_H
+
+#include "sales.h"
+#include "sales_hll.h"
+
+#define STATS_TABLE_SIZE 256 // Must be a power of two and at least twice MAX_BOOKS / MAX_CUSTOMERS
+#define SALES_STATS_DATA_FILE "data/sales_stats.csv"
+#define STATS_CHECKPOINT_INTERVAL 64 // Sales between snapshots; startup replays the rest from the sales file
+
+// Running totals for a single title (ISBN 0 marks an empty slot)
+typedef struct {
+    int ISBN;
+    int unitsSold;
+    int numSales;
+    double revenue;
+    HyperLogLog buyers; // Approximate distinct customers for this title
+} BookTotals;
+
+// Running totals for a single customer (customerID 0 marks an empty slot)
+typedef struct {
+    int customerID;
+    int numPurchases;
+    double totalSpent;
+} CustomerTotals;
+
+// Materialized sales aggregates, kept in step with the sales array.
+// Protected by the same lock as the sales array it mirrors.
+typedef struct {
+    BookTotals books[STATS_TABLE_SIZE];
+    CustomerTotals customers[STATS_TABLE_SIZE];
+    int numSales;   // Number of sales folded into the totals
+    long unitsSold; // Store-wide units sold
+    double revenue; // Store-wide revenue
+} SalesStats;
+
+extern SalesStats salesStats; // Guarded by bookMutex, which every sale is recorded under
+
+// Function prototypes (declarations)
+void resetSalesStats(SalesStats *stats);
+void recordSaleStats(SalesStats *stats, const Sale *sale);
+void rebuildSalesStats(SalesStats *stats, const Sale *sales, int numSales);
+void mergeSalesStats(SalesStats *into, const SalesStats *from);
+void addBookTotals(SalesStats *stats, const BookTotals *totals);
+void addCustomerTotals(SalesStats *stats, const CustomerTotals *totals);
+const BookTotals* getBookTotals(const SalesStats *stats, int ISBN);
+const CustomerTotals* getCustomerTotals(const SalesStats *stats, int customerID);
+void saveSalesStats(const SalesStats *stats);
+void checkpointSalesStats(const SalesStats *stats);
+int loadSalesStats(SalesStats *stats);
+int catchUpSalesStats(SalesStats *stats, const Sale *sales, int numSales);
+
+#endif // SALES_STATS_H
@@ -0,0 +1,164 @@
+#include <string.h>
+#include "sales_topk.h"
+#include "../metrics/trace.h"
+
+// Global leader boards (guarded by the lock that guards the sales array)
+TopK topBooks;
+TopK topCustomers;
+
+static unsigned int topkSlot(int key) {
+    return ((unsigned int)key * 2654435761u) & (TOPK_MAP_SIZE - 1);
+}
+
+// Map slot holding key, or the empty slot where it would go
+static int mapFind(const TopK *topk, int key) {
+    unsigned int slot = topkSlot(key);
+    while (topk->mapKey[slot] != 0 && topk->mapKey[slot] != key) {
+        slot = (slot + 1) & (TOPK_MAP_SIZE - 1);
+    }
+    return (int)slot;
+}
+
+static void mapSet(TopK *topk, int key, int pos) {
+    int slot = mapFind(topk, key);
+    topk->mapKey[slot] = key;
+    topk->mapPos[slot] = pos;
+}
+
+// Remove a key with backward-shift deletion so probe chains stay intact
+static void mapRemove(TopK *topk, int key) {
+    unsigned int hole = (unsigned int)mapFind(topk, key);
+    if (topk->mapKey[hole] == 0) {
+        return;
+    }
+    topk->mapKey[hole] = 0;
+
+    unsigned int slot = (hole + 1) & (TOPK_MAP_SIZE - 1);
+    while (topk->mapKey[slot] != 0) {
+        unsigned int home = topkSlot(topk->mapKey[slot]);
+        // Move the entry back if its home is not cyclically within (hole, slot]
+        if (((slot - home) & (TOPK_MAP_SIZE - 1)) >= ((slot - hole) & (TOPK_MAP_SIZE - 1))) {
+            topk->mapKey[hole] = topk->mapKey[slot];
+            topk->mapPos[hole] = topk->mapPos[slot];
+            topk->mapKey[slot] = 0;
+            hole = slot;
+        }
+        slot = (slot + 1) & (TOPK_MAP_SIZE - 1);
+    }
+}
+
+static void heapSwap(TopK *topk, int a, int b) {
+    TopKEntry tmp = topk->heap[a];
+    topk->heap[a] = topk->heap[b];
+    topk->heap[b] = tmp;
+    mapSet(topk, topk->heap[a].key, a);
+    mapSet(topk, topk->heap[b].key, b);
+}
+
+static void siftUp(TopK *topk, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (topk->heap[parent].value <= topk->heap[pos].value) {
+            break;
+        }
+        heapSwap(topk, parent, pos);
+        pos = parent;
+    }
+}
+
+static void siftDown(TopK *topk, int pos) {
+    for (;;) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < topk->size && topk->heap[left].value < topk->heap[smallest].value) {
+            smallest = left;
+        }
+        if (right < topk->size && topk->heap[right].value < topk->heap[smallest].value) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heapSwap(topk, pos, smallest);
+        pos = smallest;
+    }
+}
+
+void resetTopK(TopK *topk) {
+    memset(topk, 0, sizeof(*topk));
+}
+
+// Offer a key's new running total in O(log N)
+void offerTopK(TopK *topk, int key, double value) {
+    int slot = mapFind(topk, key);
+    if (topk->mapKey[slot] == key) {
+        // Already a leader: its value grew, so it can only move away from the root
+        int pos = topk->mapPos[slot];
+        topk->heap[pos].value = value;
+        siftDown(topk, pos);
+        return;
+    }
+
+    if (topk->size < TOPK_CAPACITY) {
+        int pos = topk->size++;
+        topk->heap[pos].key = key;
+        topk->heap[pos].value = value;
+        mapSet(topk, key, pos);
+        siftUp(topk, pos);
+        return;
+    }
+
+    // Replace the weakest leader if the newcomer beats it
+    if (value > topk->heap[0].value) {
+        mapRemove(topk, topk->heap[0].key);
+        topk->heap[0].key = key;
+        topk->heap[0].value = value;
+        mapSet(topk, key, 0);
+        siftDown(topk, 0);
+    }
+}
+
+int getTopK(const TopK *topk, TopKEntry *out) {
+    int count = topk->size;
+    memcpy(out, topk->heap, count * sizeof(TopKEntry));
+
+    // Insertion sort, highest first (count is at most TOPK_CAPACITY)
+    for (int i = 1; i < count; i++) {
+        TopKEntry entry = out[i];
+        int j = i - 1;
+        while (j >= 0 && out[j].value < entry.value) {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = entry;
+    }
+    return count;
+}
+
+// Push the totals touched by a sale into the leader boards
+void updateSalesLeaders(const SalesStats *stats, const Sale *sale) {
+    const BookTotals *book = getBookTotals(stats, sale->ISBN);
+    if (book) {
+        offerTopK(&topBooks, book->ISBN, book->unitsSold);
+    }
+    const CustomerTotals *customer = getCustomerTotals(stats, sale->customerID);
+    if (customer) {
+        offerTopK(&topCustomers, customer->customerID, customer->totalSpent);
+    }
+}
+
+// Seed the leader boards from the materialized totals in O(books + customers)
+void rebuildSalesLeaders(const SalesStats *stats) {
+    TRACE_SPAN("rebuildSalesLeaders");
+    resetTopK(&topBooks);
+    resetTopK(&topCustomers);
+    for (int i = 0; i < STATS_TABLE_SIZE; i++) {
+        if (stats->books[i].ISBN != 0) {
+            offerTopK(&topBooks, stats->books[i].ISBN, stats->books[i].unitsSold);
+        }
+        if (stats->customers[i].customerID != 0) {
+            offerTopK(&topCustomers, stats->customers[i].customerID, stats->customers[i].totalSpent);
+        }
+    }
+}
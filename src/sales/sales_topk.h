@@ -0,0 +1,35 @@
+#ifndef SALES_TOPK_H
+#define SALES_TOPK_H
+
+#include "sales.h"
+#include "sales_stats.h"
+
+#define TOPK_CAPACITY 10
+#define TOPK_MAP_SIZE 32 // Power of two, larger than TOPK_CAPACITY
+
+// One ranked key (ISBN or customer ID) and its running total
+typedef struct {
+    int key;
+    double value;
+} TopKEntry;
+
+// Bounded min-heap of the current leaders plus a key -> heap position map.
+// Values offered for a key must never decrease (they are running totals).
+typedef struct {
+    TopKEntry heap[TOPK_CAPACITY];
+    int size;
+    int mapKey[TOPK_MAP_SIZE]; // 0 marks an empty slot
+    int mapPos[TOPK_MAP_SIZE];
+} TopK;
+
+extern TopK topBooks;     // Bestsellers by copies sold
+extern TopK topCustomers; // Top spenders by total spent
+
+// Function prototypes (declarations)
+void resetTopK(TopK *topk);
+void offerTopK(TopK *topk, int key, double value);
+int getTopK(const TopK *topk, TopKEntry *out); // Leaders, highest first; returns the count
+void updateSalesLeaders(const SalesStats *stats, const Sale *sale);
+void rebuildSalesLeaders(const SalesStats *stats);
+
+#endif // SALES_TOPK_H
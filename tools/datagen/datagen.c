@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "datagen.h"
+
+#define FIRST_ISBN 100000000
+#define FIRST_CUSTOMER_ID 1
+#define BASE_TIMESTAMP 1704067200L      // 2024-01-01 00:00:00 UTC
+#define SALES_SPAN_SECONDS (365L * 86400L)
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+static const char *titleWords[] = {
+    "The", "Silent", "Garden", "Of", "Winter", "Shadow", "River", "Last", "Kingdom", "Memory",
+    "Glass", "Empire", "Stars", "Forgotten", "House", "Night", "Secret", "Ocean", "Fire", "Light",
+    "Iron", "Dream", "City", "Lost", "Children", "Storm", "Song", "Mountain", "Ashes", "Crown",
+    "Little", "Journey", "Hidden", "Golden", "Wild", "Road", "Letters", "Stone", "Island", "Summer",
+    "History", "Guide", "Introduction", "Principles", "Modern", "Practical", "Art", "Science", "Life", "World"
+};
+static const char *firstNames[] = {
+    "James", "Mary", "John", "Patricia", "Robert", "Jennifer", "Michael", "Linda", "William", "Elizabeth",
+    "David", "Barbara", "Richard", "Susan", "Joseph", "Jessica", "Thomas", "Sarah", "Omar", "Karen",
+    "Ahmed", "Fatima", "Yuki", "Chen", "Ana", "Lucas", "Sofia", "Mateo", "Amara", "Ivan"
+};
+static const char *lastNames[] = {
+    "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller", "Davis", "Rodriguez", "Martinez",
+    "Hernandez", "Lopez", "Gonzalez", "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
+    "Tolkien", "Austen", "Orwell", "Morrison", "Murakami", "Achebe", "Atwood", "Rowling", "Christie", "King"
+};
+
+#define COUNT_OF(array) ((int)(sizeof(array) / sizeof((array)[0])))
+
+// splitmix64: small, fast and fully determined by the seed
+static uint64_t nextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double nextUniform(uint64_t *state) {
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static long nextBelow(uint64_t *state, long bound) {
+    return (long)(nextRandom(state) % (uint64_t)bound);
+}
+
+void defaultDatagenConfig(DatagenConfig *config) {
+    config->numBooks = 10000;
+    config->numCustomers = 5000;
+    config->numSales = 100000;
+    config->seed = 42;
+    config->zipfExponent = 1.0;
+    config->outDir = NULL; // No default: a stray run must not clobber a live store's data/
+    config->overwrite = 0;
+}
+
+static FILE *openOutput(const DatagenConfig *config, const char *name, char **buffer) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", config->outDir, name);
+    FILE *file = fopen(path, config->overwrite ? "w" : "wx");
+    if (!file) {
+        if (errno == EEXIST) {
+            fprintf(stderr, "Error: %s already exists; refusing to overwrite it.\n", path);
+        } else {
+            perror(path);
+        }
+        return NULL;
+    }
+    *buffer = malloc(OUTPUT_BUFFER_SIZE);
+    if (*buffer) {
+        setvbuf(file, *buffer, _IOFBF, OUTPUT_BUFFER_SIZE);
+    }
+    return file;
+}
+
+static int closeOutput(FILE *file, char *buffer) {
+    int failed = ferror(file) != 0;
+    if (fclose(file) != 0) {
+        failed = 1;
+    }
+    free(buffer);
+    if (failed) {
+        perror("Error writing dataset");
+    }
+    return failed ? -1 : 0;
+}
+
+// Title of 1-8 words (most 2-5), always under MAX_TITLE_LENGTH
+static void makeTitle(uint64_t *state, char *out, size_t size) {
+    int words = 1 + (int)nextBelow(state, 4) + (int)nextBelow(state, 4);
+    size_t used = 0;
+    out[0] = '\0';
+    for (int w = 0; w < words; w++) {
+        const char *word = titleWords[nextBelow(state, COUNT_OF(titleWords))];
+        int written = snprintf(out + used, size - used, w == 0 ? "%s" : " %s", word);
+        if (written < 0 || (size_t)written >= size - used) {
+            out[used] = '\0';
+            break;
+        }
+        used += (size_t)written;
+    }
+}
+
+static void makePersonName(uint64_t *state, char *out, size_t size) {
+    snprintf(out, size, "%s %s", firstNames[nextBelow(state, COUNT_OF(firstNames))],
+             lastNames[nextBelow(state, COUNT_OF(lastNames))]);
+}
+
+// Prices cluster around 10-25 with a long tail, in whole cents
+static float makePrice(uint64_t *state) {
+    double price = exp(2.2 + 0.6 * (nextUniform(state) + nextUniform(state) + nextUniform(state) - 1.5));
+    if (price < 1.99) price = 1.99;
+    if (price > 199.99) price = 199.99;
+    return (float)(floor(price * 100.0) / 100.0);
+}
+
+static int writeBooks(const DatagenConfig *config, uint64_t *state, float *prices) {
+    char *buffer;
+    FILE *file = openOutput(config, "books.csv", &buffer);
+    if (!file) {
+        return -1;
+    }
+
+    char title[100], author[50];
+    fprintf(file, "ISBN,Title,Author,Price,Quantity\n");
+    for (long i = 0; i < config->numBooks; i++) {
+        makeTitle(state, title, sizeof(title));
+        makePersonName(state, author, sizeof(author));
+        prices[i] = makePrice(state);
+        fprintf(file, "%ld,%s,%s,%.2f,%ld\n", FIRST_ISBN + i, title, author, prices[i], nextBelow(state, 200));
+    }
+    return closeOutput(file, buffer);
+}
+
+static int writeCustomers(const DatagenConfig *config, uint64_t *state) {
+    char *buffer;
+    FILE *file = openOutput(config, "customers.csv", &buffer);
+    if (!file) {
+        return -1;
+    }
+
+    char name[50];
+    for (long i = 0; i < config->numCustomers; i++) {
+        makePersonName(state, name, sizeof(name));
+        fprintf(file, "%ld,%s,%03ld%07ld\n", FIRST_CUSTOMER_ID + i, name,
+                200 + nextBelow(state, 800), nextBelow(state, 10000000));
+    }
+    return closeOutput(file, buffer);
+}
+
+// Cumulative Zipf weights over popularity ranks 1..n
+static double *buildZipfTable(long n, double exponent) {
+    double *cdf = malloc((size_t)n * sizeof(double));
+    if (!cdf) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+    double total = 0.0;
+    for (long rank = 0; rank < n; rank++) {
+        total += 1.0 / pow((double)(rank + 1), exponent);
+        cdf[rank] = total;
+    }
+    for (long rank = 0; rank < n; rank++) {
+        cdf[rank] /= total;
+    }
+    return cdf;
+}
+
+static long sampleZipf(const double *cdf, long n, uint64_t *state) {
+    double u = nextUniform(state);
+    long low = 0, high = n - 1;
+    while (low < high) {
+        long mid = low + (high - low) / 2;
+        if (cdf[mid] < u) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static long gcd(long a, long b) {
+    while (b != 0) {
+        long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int writeSales(const DatagenConfig *config, uint64_t *state, const float *prices) {
+    double *cdf = buildZipfTable(config->numBooks, config->zipfExponent);
+    if (!cdf) {
+        return -1;
+    }
+
+    // Spread popularity ranks over the catalog so bestsellers are not just the first ISBNs
+    long stride = 7919 % config->numBooks;
+    while (stride == 0 || gcd(stride, config->numBooks) != 1) {
+        stride++;
+    }
+
+    char *buffer;
+    FILE *file = openOutput(config, "sales.csv", &buffer);
+    if (!file) {
+        free(cdf);
+        return -1;
+    }
+
+    for (long i = 0; i < config->numSales; i++) {
+        long rank = sampleZipf(cdf, config->numBooks, state);
+        long book = (long)(((unsigned long long)rank * (unsigned long long)stride) % (unsigned long long)config->numBooks);
+        long customer = nextBelow(state, config->numCustomers);
+        long quantity = 1 + (nextBelow(state, 10) == 0 ? nextBelow(state, 5) : 0);
+        long timestamp = BASE_TIMESTAMP + (long)((double)SALES_SPAN_SECONDS * i / config->numSales);
+        fprintf(file, "%ld %ld %ld %ld %.2f %ld\n", i + 1, FIRST_CUSTOMER_ID + customer, FIRST_ISBN + book,
+                quantity, prices[book] * quantity, timestamp);
+    }
+
+    free(cdf);
+    return closeOutput(file, buffer);
+}
+
+int generateDataset(const DatagenConfig *config) {
+    if (!config->outDir || config->outDir[0] == '\0') {
+        fprintf(stderr, "Error: An output directory is required.\n");
+        return -1;
+    }
+    if (config->numBooks <= 0 || config->numCustomers <= 0 || config->numSales < 0) {
+        fprintf(stderr, "Error: Books and customers must be positive, sales non-negative.\n");
+        return -1;
+    }
+    if (config->numBooks > 2000000000L - FIRST_ISBN) {
+        fprintf(stderr, "Error: Too many books for integer ISBNs.\n");
+        return -1;
+    }
+
+    float *prices = malloc((size_t)config->numBooks * sizeof(float));
+    if (!prices) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+
+    // Independent streams per file, so changing one cardinality leaves the others unchanged
+    uint64_t bookState = config->seed * 3 + 1;
+    uint64_t customerState = config->seed * 3 + 2;
+    uint64_t saleState = config->seed * 3 + 3;
+
+    int status = writeBooks(config, &bookState, prices);
+    if (status == 0) {
+        status = writeCustomers(config, &customerState);
+    }
+    if (status == 0) {
+        status = writeSales(config, &saleState, prices);
+    }
+
+    free(prices);
+    return status;
+}
@@ -0,0 +1,24 @@
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include <stdint.h>
+
+// Settings for one synthetic dataset (same seed and sizes give identical files)
+typedef struct {
+    long numBooks;
+    long numCustomers;
+    long numSales;
+    uint64_t seed;
+    double zipfExponent; // Title popularity skew; 0 is uniform, ~1 is typical retail
+    const char *outDir;  // Receives books.csv, customers.csv and sales.csv; required
+    int overwrite;       // Replace existing files instead of refusing (scratch directories only)
+} DatagenConfig;
+
+// Function prototypes (declarations)
+void defaultDatagenConfig(DatagenConfig *config);
+// Writes the three files in the formats loadBooks, loadCustomers and loadSales
+// read. Refuses to replace existing files unless overwrite is set.
+// Returns 0 on success, -1 on error.
+int generateDataset(const DatagenConfig *config);
+
+#endif // DATAGEN_H